@@ -42,9 +42,17 @@
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
-volatile uint32_t _osal_base_prio = 0 ;
+volatile uint32_t _osal_base_prio[OSAL_ISR_LOCK_DEPTH] ;
+volatile uint32_t _osal_base_prio_depth = 0 ;
 BaseType_t _osal_xHigherPriorityTaskWoken = 0 ;
 
+#if OSAL_IRQ_TRACE == TRUE
+volatile uint32_t _osal_irq_nesting = 0 ;
+static volatile uint32_t _osal_irq_trace_head = 0 ;
+static osal_irq_event_t _osal_irq_trace_buffer[OSAL_IRQ_TRACE_BUFFER] ;
+static osal_irq_stats_t _osal_irq_stats[OSAL_IRQ_TRACE_VECTORS] ;
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
@@ -74,4 +82,177 @@ void chSysPolledDelayX(rtcnt_t cycles) {
 }
 
 
+/**
+ * @brief   Removes a waiter from a threads queue.
+ * @note    Only used on timeout, the dequeue paths unlink from the head.
+ *
+ * @param[in] tqp       pointer to the threads queue object
+ * @param[in] wp        pointer to the waiter to be removed
+ *
+ * @notapi
+ */
+void _osal_threads_queue_remove(threads_queue_t *tqp, osal_waiter_t *wp) {
+  osal_waiter_t *prev = NULL;
+  osal_waiter_t *cur = tqp->head;
+
+  while ((cur != NULL) && (cur != wp)) {
+    prev = cur;
+    cur  = cur->next;
+  }
+  if (cur == NULL) {
+    return;
+  }
+
+  if (prev == NULL) {
+    tqp->head = wp->next;
+  }
+  else {
+    prev->next = wp->next;
+  }
+  if (tqp->tail == wp) {
+    tqp->tail = prev;
+  }
+}
+
+#if (OSAL_IRQ_TRACE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   IRQ trace exit hook.
+ * @details Updates the statistics of the current vector and appends an
+ *          event to the ring buffer. Slots are claimed with an atomic
+ *          increment so nested handlers never share a slot.
+ * @note    The statistics of a vector are only written by that vector,
+ *          an exception cannot preempt itself.
+ *
+ * @param[in] start     cycle counter at handler entry
+ *
+ * @notapi
+ */
+void _osal_irq_trace_leave_hook(rtcnt_t start) {
+  rtcnt_t cycles = DWT->CYCCNT - start;
+  uint32_t vector = __get_IPSR() & 0x1FFU;
+  osal_irq_event_t *ep;
+  uint32_t seq;
+
+  _osal_irq_nesting--;
+
+  if (vector < OSAL_IRQ_TRACE_VECTORS) {
+    osal_irq_stats_t *sp = &_osal_irq_stats[vector];
+
+    if ((sp->count == 0U) || (cycles < sp->min)) {
+      sp->min = cycles;
+    }
+    if (cycles > sp->max) {
+      sp->max = cycles;
+    }
+    sp->total += cycles;
+    sp->count++;
+  }
+
+  seq = __atomic_add_fetch(&_osal_irq_trace_head, 1U, __ATOMIC_RELAXED);
+  if (seq == 0U) {
+    /* Zero marks a slot being written, skipped on wrap.*/
+    seq = __atomic_add_fetch(&_osal_irq_trace_head, 1U, __ATOMIC_RELAXED);
+  }
+  ep = &_osal_irq_trace_buffer[seq & (OSAL_IRQ_TRACE_BUFFER - 1U)];
+  ep->seq = 0U;
+  __DMB();
+  ep->start   = start;
+  ep->cycles  = cycles;
+  ep->vector  = (uint16_t)vector;
+  ep->nesting = (uint16_t)_osal_irq_nesting;
+  __DMB();
+  ep->seq = seq;
+}
+
+/**
+ * @brief   Clears the IRQ statistics and the events ring buffer.
+ * @note    Handlers running at a priority above
+ *          @p configMAX_SYSCALL_INTERRUPT_PRIORITY are not masked and
+ *          can leave a partially cleared entry.
+ *
+ * @api
+ */
+void osalIrqTraceReset(void) {
+  uint32_t i;
+
+  osalSysLock();
+  for (i = 0U; i < OSAL_IRQ_TRACE_VECTORS; i++) {
+    _osal_irq_stats[i].count = 0U;
+    _osal_irq_stats[i].min   = 0U;
+    _osal_irq_stats[i].max   = 0U;
+    _osal_irq_stats[i].total = 0U;
+  }
+  for (i = 0U; i < OSAL_IRQ_TRACE_BUFFER; i++) {
+    _osal_irq_trace_buffer[i].seq = 0U;
+  }
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns the duration statistics of an exception number.
+ *
+ * @param[in] vector    exception number, IRQn + 16 for peripherals
+ * @param[out] sp       pointer to the statistics copy
+ * @return              The vector has been invoked at least once.
+ *
+ * @api
+ */
+bool osalIrqTraceGetStats(uint32_t vector, osal_irq_stats_t *sp) {
+
+  osalDbgCheck((vector < OSAL_IRQ_TRACE_VECTORS) && (sp != NULL));
+
+  osalSysLock();
+  *sp = _osal_irq_stats[vector];
+  osalSysUnlock();
+
+  return sp->count > 0U;
+}
+
+/**
+ * @brief   Copies the most recent IRQ events.
+ * @details Events are copied oldest first without stopping the tracing,
+ *          slots overwritten during the copy are skipped.
+ *
+ * @param[out] ep       pointer to the events array
+ * @param[in] n         size of the events array
+ * @return              The number of events copied.
+ *
+ * @api
+ */
+size_t osalIrqTraceGetEvents(osal_irq_event_t *ep, size_t n) {
+  uint32_t head = __atomic_load_n(&_osal_irq_trace_head, __ATOMIC_RELAXED);
+  uint32_t seq;
+  size_t copied = 0U;
+
+  osalDbgCheck(ep != NULL);
+
+  if (n > OSAL_IRQ_TRACE_BUFFER) {
+    n = OSAL_IRQ_TRACE_BUFFER;
+  }
+
+  for (seq = head - (uint32_t)n + 1U; copied < n; seq++) {
+    const osal_irq_event_t *slot =
+        &_osal_irq_trace_buffer[seq & (OSAL_IRQ_TRACE_BUFFER - 1U)];
+
+    if ((seq == 0U) || (slot->seq != seq)) {
+      if (seq == head) {
+        break;
+      }
+      continue;
+    }
+    __DMB();
+    ep[copied] = *slot;
+    __DMB();
+    if (slot->seq == seq) {
+      copied++;
+    }
+    if (seq == head) {
+      break;
+    }
+  }
+
+  return copied;
+}
+#endif
+
 /** @} */
@@ -122,6 +122,57 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Maximum nesting depth of the ISR critical zones.
+ * @details Each level of interrupt nesting holding an ISR critical zone
+ *          takes one slot.
+ */
+#if !defined(OSAL_ISR_LOCK_DEPTH) || defined(__DOXYGEN__)
+#define OSAL_ISR_LOCK_DEPTH                 8
+#endif
+
+/**
+ * @brief   Task notification index reserved to the OSAL.
+ * @details Thread references are suspended and resumed using this entry
+ *          of the task notifications array, the other entries are left to
+ *          the application.
+ * @note    The default is the last entry, set
+ *          @p configTASK_NOTIFICATION_ARRAY_ENTRIES to at least 2 in order
+ *          to not share the entry 0 with the application.
+ */
+#if !defined(OSAL_NOTIFY_INDEX) || defined(__DOXYGEN__)
+#define OSAL_NOTIFY_INDEX                   (configTASK_NOTIFICATION_ARRAY_ENTRIES - 1)
+#endif
+
+/**
+ * @brief   Enables the IRQ handlers tracing.
+ * @details If enabled, @p OSAL_IRQ_PROLOGUE() and @p OSAL_IRQ_EPILOGUE()
+ *          timestamp every handler with the DWT cycle counter, keep
+ *          per-vector duration statistics and record the recent events
+ *          into a ring buffer.
+ */
+#if !defined(OSAL_IRQ_TRACE) || defined(__DOXYGEN__)
+#define OSAL_IRQ_TRACE                      FALSE
+#endif
+
+/**
+ * @brief   Number of events in the IRQ trace ring buffer.
+ * @note    Must be a power of two.
+ */
+#if !defined(OSAL_IRQ_TRACE_BUFFER) || defined(__DOXYGEN__)
+#define OSAL_IRQ_TRACE_BUFFER               64
+#endif
+
+/**
+ * @brief   Number of exception numbers with duration statistics.
+ * @details Exceptions are identified by the IPSR value, system exceptions
+ *          are 0..15 and the peripheral IRQn is the exception number
+ *          minus 16.
+ */
+#if !defined(OSAL_IRQ_TRACE_VECTORS) || defined(__DOXYGEN__)
+#define OSAL_IRQ_TRACE_VECTORS              160
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -132,11 +183,28 @@
 #error "invalid OSAL_ST_RESOLUTION, must be 16 or 32"
 #endif
 
+#if (OSAL_NOTIFY_INDEX < 0) ||                                              \
+    (OSAL_NOTIFY_INDEX >= configTASK_NOTIFICATION_ARRAY_ENTRIES)
+#error "invalid OSAL_NOTIFY_INDEX"
+#endif
+
+#if OSAL_IRQ_TRACE == TRUE
+#if (OSAL_IRQ_TRACE_BUFFER < 1) ||                                          \
+    ((OSAL_IRQ_TRACE_BUFFER & (OSAL_IRQ_TRACE_BUFFER - 1)) != 0)
+#error "OSAL_IRQ_TRACE_BUFFER must be a power of two"
+#endif
+
+#if (OSAL_IRQ_TRACE_VECTORS < 16) || (OSAL_IRQ_TRACE_VECTORS > 512)
+#error "invalid OSAL_IRQ_TRACE_VECTORS"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
-extern volatile uint32_t _osal_base_prio ;
+extern volatile uint32_t _osal_base_prio[OSAL_ISR_LOCK_DEPTH] ;
+extern volatile uint32_t _osal_base_prio_depth ;
 extern BaseType_t _osal_xHigherPriorityTaskWoken  ;
 
 #if 1
@@ -213,14 +281,94 @@ typedef StaticQueue_t mutex_t;
 
 
 #if 1
+/**
+ * @brief   Type of a thread queue waiter.
+ * @details Waiters are allocated on the stack of the waiting thread and
+ *          stay linked to the queue for the duration of the wait.
+ */
+typedef struct osal_waiter {
+  /**
+   * @brief   Next waiter in FIFO order.
+   */
+  struct osal_waiter        *next;
+  /**
+   * @brief   Waiting thread, @p NULL once dequeued.
+   */
+  TaskHandle_t              task;
+  /**
+   * @brief   Message delivered by the dequeue operation.
+   */
+  volatile msg_t            msg;
+} osal_waiter_t;
+
 /**
  * @brief   Type of a thread queue.
  * @details A thread queue is a queue of sleeping threads, queued threads
  *          can be dequeued one at time or all together.
- * @note    In this implementation it is implemented as a single reference
- *          because there are no real threads.
- */
-typedef StaticQueue_t threads_queue_t;
+ * @note    In this implementation it is a FIFO list of waiters, each
+ *          waiter is woken individually and receives the message code.
+ */
+typedef struct {
+  /**
+   * @brief   First waiter, @p NULL if the queue is empty.
+   */
+  osal_waiter_t             *head;
+  /**
+   * @brief   Last waiter.
+   */
+  osal_waiter_t             *tail;
+} threads_queue_t;
+#endif
+
+#if (OSAL_IRQ_TRACE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of an IRQ trace event.
+ */
+typedef struct {
+  /**
+   * @brief   Sequence number, written last, zero while the slot is updated.
+   */
+  volatile uint32_t         seq;
+  /**
+   * @brief   Cycle counter at handler entry.
+   */
+  rtcnt_t                   start;
+  /**
+   * @brief   Handler duration in cycles.
+   * @note    Includes the time spent in nested handlers.
+   */
+  rtcnt_t                   cycles;
+  /**
+   * @brief   Exception number, from IPSR.
+   */
+  uint16_t                  vector;
+  /**
+   * @brief   Handlers nesting level, zero for a non-nested handler.
+   */
+  uint16_t                  nesting;
+} osal_irq_event_t;
+
+/**
+ * @brief   Type of the IRQ duration statistics of a vector.
+ */
+typedef struct {
+  /**
+   * @brief   Number of handler invocations.
+   */
+  uint32_t                  count;
+  /**
+   * @brief   Shortest handler duration in cycles.
+   */
+  rtcnt_t                   min;
+  /**
+   * @brief   Longest handler duration in cycles.
+   */
+  rtcnt_t                   max;
+  /**
+   * @brief   Total cycles, the average is @p total / @p count.
+   */
+  uint64_t                  total;
+} osal_irq_stats_t;
 #endif
 
 /*===========================================================================*/
@@ -281,21 +429,46 @@ typedef StaticQueue_t threads_queue_t;
  */
 #define OSAL_IRQ_IS_VALID_PRIORITY(n) 1
 
+/**
+ * @brief   IRQ trace entry and exit hooks.
+ *
+ * @notapi
+ */
+#if (OSAL_IRQ_TRACE == TRUE) || defined(__DOXYGEN__)
+#define _osal_irq_trace_enter() \
+		rtcnt_t _osal_irq_start = _osal_irq_trace_enter_hook()
+#define _osal_irq_trace_leave() \
+		_osal_irq_trace_leave_hook(_osal_irq_start)
+#else
+#define _osal_irq_trace_enter() \
+		do { } while (false)
+#define _osal_irq_trace_leave() \
+		do { } while (false)
+#endif
+
 /**
  * @brief   IRQ prologue code.
  * @details This macro must be inserted at the start of all IRQ handlers.
+ *          The woken flag of the interrupted context is saved on the
+ *          handler stack and a clean flag is started for this handler,
+ *          nested interrupts do not see each other's state.
  */
 #define OSAL_IRQ_PROLOGUE() \
-		_osal_xHigherPriorityTaskWoken = 0 ; \
-		// CH_IRQ_PROLOGUE()
+		_osal_irq_trace_enter() ; \
+		BaseType_t _osal_outer_woken = _osal_xHigherPriorityTaskWoken ; \
+		_osal_xHigherPriorityTaskWoken = pdFALSE
 
 /**
  * @brief   IRQ epilogue code.
  * @details This macro must be inserted at the end of all IRQ handlers.
+ *          The context switch requested by the I-class functions invoked
+ *          within the handler is performed once, here, then the woken flag
+ *          of the interrupted context is restored.
  */
 #define OSAL_IRQ_EPILOGUE() \
 		portYIELD_FROM_ISR( _osal_xHigherPriorityTaskWoken ); \
-		// CH_IRQ_EPILOGUE()
+		_osal_xHigherPriorityTaskWoken = _osal_outer_woken ; \
+		_osal_irq_trace_leave()
 
 /**
  * @brief   IRQ handler function declaration.
@@ -448,6 +621,13 @@ extern "C" {
 #endif
 
  void chSysPolledDelayX(rtcnt_t cycles) ;
+ void _osal_threads_queue_remove(threads_queue_t *tqp, osal_waiter_t *wp) ;
+#if OSAL_IRQ_TRACE == TRUE
+ void _osal_irq_trace_leave_hook(rtcnt_t start) ;
+ void osalIrqTraceReset(void) ;
+ bool osalIrqTraceGetStats(uint32_t vector, osal_irq_stats_t *sp) ;
+ size_t osalIrqTraceGetEvents(osal_irq_event_t *ep, size_t n) ;
+#endif
 
 #ifdef __cplusplus
 }
@@ -457,6 +637,24 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
+#if (OSAL_IRQ_TRACE == TRUE) || defined(__DOXYGEN__)
+extern volatile uint32_t _osal_irq_nesting ;
+
+/**
+ * @brief   IRQ trace entry hook.
+ *
+ * @return              The cycle counter at handler entry.
+ *
+ * @notapi
+ */
+static inline rtcnt_t _osal_irq_trace_enter_hook(void) {
+	rtcnt_t start = DWT->CYCCNT ;
+
+	_osal_irq_nesting++ ;
+	return start ;
+}
+#endif
+
 /**
  * @brief   OSAL module initialization.
  *
@@ -509,8 +707,6 @@ static inline void osalSysEnable(void) {
 static inline void osalSysLock(void) {
 
 	portENTER_CRITICAL();
-	xTaskNotifyStateClear (xTaskGetCurrentTaskHandle ()) ;
-	//ulTaskNotifyTakeS (pdTRUE, 0) ;
 }
 
 /**
@@ -526,27 +722,41 @@ static inline void osalSysUnlock(void) {
 
 /**
  * @brief   Enters a critical zone from ISR context.
- * @note    This function cannot be used for reentrant critical zones.
+ * @details The previous mask is pushed on a LIFO of saved masks, an
+ *          interrupt nesting within the critical zone, from a priority
+ *          above the kernel threshold, uses the next slot and releases it
+ *          before returning.
+ * @note    The slot is reserved before being written so that a nesting
+ *          interrupt can never reuse it.
  *
  * @special
  */
 static inline void osalSysLockFromISR(void) {
 
-	_osal_base_prio = taskENTER_CRITICAL_FROM_ISR();
-	// _osal_xHigherPriorityTaskWoken = 0 ; // ToDo: move to OSAL_IRQ_PROLOGUE()
+	uint32_t prio = taskENTER_CRITICAL_FROM_ISR();
+	uint32_t idx = _osal_base_prio_depth ;
+
+	osalDbgAssert(idx < OSAL_ISR_LOCK_DEPTH, "ISR lock nesting overflow");
+	_osal_base_prio_depth = idx + 1U ;
+	_osal_base_prio[idx] = prio ;
 }
 
 /**
  * @brief   Leaves a critical zone from ISR context.
- * @note    This function cannot be used for reentrant critical zones.
+ * @details The mask saved by the matching @p osalSysLockFromISR() is
+ *          restored.
+ * @note    No context switch is requested here, it is deferred to
+ *          @p OSAL_IRQ_EPILOGUE().
  *
  * @special
  */
 static inline void osalSysUnlockFromISR(void) {
 
-	BaseType_t xHigherPriorityTaskWoke = _osal_xHigherPriorityTaskWoken ;
-	taskEXIT_CRITICAL_FROM_ISR(_osal_base_prio);
-	portYIELD_FROM_ISR( xHigherPriorityTaskWoke ); // ToDo: move to OSAL_IRQ_EPILOGUE()
+	uint32_t idx = _osal_base_prio_depth - 1U ;
+	uint32_t prio = _osal_base_prio[idx] ;
+
+	_osal_base_prio_depth = idx ;
+	taskEXIT_CRITICAL_FROM_ISR(prio);
 }
 
 /**
@@ -625,13 +835,16 @@ static inline void osalOsTimerHandlerI(void) {
  * @note    I-Class functions invoked from thread context must not reschedule
  *          by themselves, an explicit reschedule using this function is
  *          required in this scenario.
- * @note    Not implemented in this simplified OSAL.
+ * @note    The yield is pended and taken when the critical zone is left.
  *
  * @sclass
  */
 static inline void osalOsRescheduleS(void) {
 
-////!!  chSchRescheduleS();
+	if (_osal_xHigherPriorityTaskWoken != pdFALSE) {
+		_osal_xHigherPriorityTaskWoken = pdFALSE ;
+		portYIELD_WITHIN_API() ;
+	}
 }
 
 /**
@@ -741,6 +954,9 @@ static inline void osalThreadSleep(sysinterval_t delay) {
  * @brief   Sends the current thread sleeping and sets a reference variable.
  * @note    This function must reschedule, it can only be called from thread
  *          context.
+ * @note    A resume happening between leaving the critical zone and the
+ *          wait is not lost, it is kept pending in the reserved
+ *          notification entry.
  *
  * @param[in] trp       a pointer to a thread reference object
  * @return              The wake up message.
@@ -748,16 +964,13 @@ static inline void osalThreadSleep(sysinterval_t delay) {
  * @sclass
  */
 static inline msg_t osalThreadSuspendS(thread_reference_t *trp) {
+	uint32_t msg = (uint32_t)MSG_RESET ;
 
-   //vTaskSuspend(*trp);
 	*trp = xTaskGetCurrentTaskHandle () ;
-	msg_t msg = -1 ;
-	//osalSysUnlock () ;
-	xTaskNotifyWaitS( (uint32_t) -1, (uint32_t) -1, (uint32_t *)&msg, TIME_INFINITE ) ;
-
-	//msg_t msg =	ulTaskNotifyTakeS( pdTRUE, TIME_INFINITE )  ;
-	//osalSysLock () ;
-	return msg ;
+	osalSysUnlock () ;
+	(void)xTaskNotifyWaitIndexed( OSAL_NOTIFY_INDEX, 0U, (uint32_t)-1, &msg, TIME_INFINITE ) ;
+	osalSysLock () ;
+	return (msg_t)msg ;
 }
 
 /**
@@ -781,16 +994,21 @@ static inline msg_t osalThreadSuspendS(thread_reference_t *trp) {
  */
 static inline msg_t osalThreadSuspendTimeoutS(thread_reference_t *trp,
                                               sysinterval_t timeout) {
-//#warning "osalThreadSuspendTimeoutS not implemented!"
-	//osalSysUnlock () ;
+	uint32_t msg = (uint32_t)MSG_RESET ;
+
 	*trp = xTaskGetCurrentTaskHandle () ;
-	msg_t msg = -1 ; //=  ulTaskNotifyTakeS( pdTRUE, timeout ) ;
-	if (xTaskNotifyWaitS( (uint32_t) -1, (uint32_t) -1, (uint32_t *)&msg, timeout ) == pdFALSE) {
-		msg = MSG_TIMEOUT ;
+	osalSysUnlock () ;
+	if (xTaskNotifyWaitIndexed( OSAL_NOTIFY_INDEX, 0U, (uint32_t)-1, &msg, timeout ) == pdFALSE) {
+		osalSysLock () ;
+		/* A resume racing with the timeout would leave a stale notification
+		   for the next suspend, the reference is dropped and the entry is
+		   cleared, this is the only path paying for it.*/
+		*trp = NULL ;
+		(void)xTaskNotifyStateClearIndexed( NULL, OSAL_NOTIFY_INDEX ) ;
+		return MSG_TIMEOUT ;
 	}
-
-	//osalSysLock () ;
-	return msg ;
+	osalSysLock () ;
+	return (msg_t)msg ;
 }
 
 /**
@@ -805,7 +1023,10 @@ static inline msg_t osalThreadSuspendTimeoutS(thread_reference_t *trp,
  */
 static inline void osalThreadResumeI(thread_reference_t *trp, msg_t msg) {
 
-	xTaskNotifyFromISR ( *trp, msg, eSetValueWithOverwrite, &_osal_xHigherPriorityTaskWoken );
+	if (*trp != NULL) {
+		xTaskNotifyIndexedFromISR ( *trp, OSAL_NOTIFY_INDEX, (uint32_t)msg, eSetValueWithOverwrite, &_osal_xHigherPriorityTaskWoken );
+		*trp = NULL ;
+	}
 }
 
 /**
@@ -820,7 +1041,10 @@ static inline void osalThreadResumeI(thread_reference_t *trp, msg_t msg) {
  */
 static inline void osalThreadResumeS(thread_reference_t *trp, msg_t msg) {
 
-	xTaskNotify( *trp, msg, eSetValueWithOverwrite );
+	if (*trp != NULL) {
+		xTaskNotifyIndexed( *trp, OSAL_NOTIFY_INDEX, (uint32_t)msg, eSetValueWithOverwrite );
+		*trp = NULL ;
+	}
 }
 
 /**
@@ -832,7 +1056,8 @@ static inline void osalThreadResumeS(thread_reference_t *trp, msg_t msg) {
  */
 static inline void osalThreadQueueObjectInit(threads_queue_t *tqp) {
 
-	xSemaphoreCreateCountingStatic ((UBaseType_t)-1, 0, (StaticSemaphore_t *)(tqp) ) ;
+	tqp->head = NULL ;
+	tqp->tail = NULL ;
 }
 
 /**
@@ -860,11 +1085,53 @@ static inline void osalThreadQueueObjectInit(threads_queue_t *tqp) {
  */
 static inline msg_t osalThreadEnqueueTimeoutS(threads_queue_t *tqp,
                                               sysinterval_t timeout) {
+	osal_waiter_t w ;
+
+	if (timeout == TIME_IMMEDIATE) {
+		return MSG_TIMEOUT ;
+	}
+
+	w.next = NULL ;
+	w.task = xTaskGetCurrentTaskHandle () ;
+	w.msg  = MSG_TIMEOUT ;
+	if (tqp->tail == NULL) {
+		tqp->head = &w ;
+	}
+	else {
+		tqp->tail->next = &w ;
+	}
+	tqp->tail = &w ;
 
 	osalSysUnlock () ;
-	uint32_t r = xSemaphoreTake( (SemaphoreHandle_t)tqp, timeout ) == pdTRUE ? MSG_OK : MSG_TIMEOUT ;
+	BaseType_t notified = xTaskNotifyWaitIndexed( OSAL_NOTIFY_INDEX, 0U, (uint32_t)-1, NULL, timeout ) ;
 	osalSysLock () ;
-	return r ;
+
+	if (w.task != NULL) {
+		/* Timeout, the waiter is still linked.*/
+		_osal_threads_queue_remove (tqp, &w) ;
+	}
+	else if (notified == pdFALSE) {
+		/* Dequeued after the timeout, the message is taken but the
+		   notification is still pending.*/
+		(void)xTaskNotifyStateClearIndexed( NULL, OSAL_NOTIFY_INDEX ) ;
+	}
+	return w.msg ;
+}
+
+/**
+ * @brief   Wakes up a dequeued waiter.
+ *
+ * @param[in] wp        pointer to the waiter
+ * @param[in] msg       the message code
+ *
+ * @notapi
+ */
+static inline void _osal_waiter_wakeupI(osal_waiter_t *wp, msg_t msg) {
+	TaskHandle_t task = wp->task ;
+
+	wp->msg  = msg ;
+	wp->task = NULL ;
+	xTaskNotifyIndexedFromISR ( task, OSAL_NOTIFY_INDEX, 0U, eNoAction, &_osal_xHigherPriorityTaskWoken );
 }
 
 /**
@@ -876,12 +1143,21 @@ static inline msg_t osalThreadEnqueueTimeoutS(threads_queue_t *tqp,
  * @iclass
  */
 static inline void osalThreadDequeueNextI(threads_queue_t *tqp, msg_t msg) {
-	//BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-	xSemaphoreGiveFromISR(tqp, &_osal_xHigherPriorityTaskWoken );
+	osal_waiter_t *wp = tqp->head ;
+
+	if (wp != NULL) {
+		tqp->head = wp->next ;
+		if (tqp->head == NULL) {
+			tqp->tail = NULL ;
+		}
+		_osal_waiter_wakeupI (wp, msg) ;
+	}
 }
 
 /**
  * @brief   Dequeues and wakes up all threads from the queue.
+ * @details The list is detached at once, then each waiter receives the
+ *          message, the time spent is linear in the number of waiters.
  *
  * @param[in] tqp       pointer to the threads queue object
  * @param[in] msg       the message code
@@ -889,9 +1165,15 @@ static inline void osalThreadDequeueNextI(threads_queue_t *tqp, msg_t msg) {
  * @iclass
  */
 static inline void osalThreadDequeueAllI(threads_queue_t *tqp, msg_t msg) {
-	//BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-	while (!uxSemaphoreGetCount((SemaphoreHandle_t)tqp)) {
-		xSemaphoreGiveFromISR(tqp, &_osal_xHigherPriorityTaskWoken );
+	osal_waiter_t *wp = tqp->head ;
+
+	tqp->head = NULL ;
+	tqp->tail = NULL ;
+	while (wp != NULL) {
+		osal_waiter_t *next = wp->next ;
+
+		_osal_waiter_wakeupI (wp, msg) ;
+		wp = next ;
 	}
 }
 
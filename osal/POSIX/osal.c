@@ -0,0 +1,335 @@
+/*
+    Copyright (C) 2015-2024, Navaro, All Rights Reserved
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+*/
+
+
+/**
+ * @file    osal.c
+ * @brief   OSAL module code, POSIX threads host simulation.
+ *
+ * @addtogroup OSAL
+ * @{
+ */
+
+#include <errno.h>
+#include <time.h>
+
+#include "osal.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   System critical zone.
+ */
+pthread_mutex_t _osal_lock = PTHREAD_MUTEX_INITIALIZER ;
+
+/**
+ * @brief   The calling host thread holds the system critical zone.
+ */
+_Thread_local bool _osal_lock_owner = false ;
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static _Thread_local osal_thread_t *_osal_thread = NULL ;
+static pthread_key_t _osal_thread_key ;
+static pthread_once_t _osal_thread_once = PTHREAD_ONCE_INIT ;
+static struct timespec _osal_epoch ;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void osal_thread_free(void *p) {
+	osal_thread_t *tp = (osal_thread_t *)p ;
+
+	(void)pthread_cond_destroy (&tp->cond) ;
+	free (tp) ;
+}
+
+static void osal_thread_key_init(void) {
+
+	(void)pthread_key_create (&_osal_thread_key, osal_thread_free) ;
+	(void)clock_gettime (CLOCK_MONOTONIC, &_osal_epoch) ;
+}
+
+static uint64_t osal_monotonic_ns(void) {
+	struct timespec ts ;
+
+	(void)clock_gettime (CLOCK_MONOTONIC, &ts) ;
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec ;
+}
+
+/* Same unlink as _osal_threads_queue_remove() in the other OSALs, only
+   used on timeout.*/
+static void osal_threads_queue_remove(threads_queue_t *tqp,
+                                      osal_waiter_t *wp) {
+	osal_waiter_t *prev = NULL ;
+	osal_waiter_t *cur = tqp->head ;
+
+	while ((cur != NULL) && (cur != wp)) {
+		prev = cur ;
+		cur  = cur->next ;
+	}
+	if (cur == NULL) {
+		return ;
+	}
+
+	if (prev == NULL) {
+		tqp->head = wp->next ;
+	}
+	else {
+		prev->next = wp->next ;
+	}
+	if (tqp->tail == wp) {
+		tqp->tail = prev ;
+	}
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   OSAL module initialization.
+ *
+ * @api
+ */
+void osalInit(void) {
+
+	(void)pthread_once (&_osal_thread_once, osal_thread_key_init) ;
+}
+
+/**
+ * @brief   System halt with error message.
+ *
+ * @param[in] reason    the halt message pointer
+ *
+ * @api
+ */
+void osalSysHalt(const char *reason) {
+
+	(void)fprintf (stderr, "osalSysHalt: %s\n", reason != NULL ? reason : "") ;
+	abort () ;
+}
+
+/**
+ * @brief   Returns the wait object of the calling host thread.
+ * @details The object is created on first use and released when the
+ *          thread exits.
+ *
+ * @notapi
+ */
+osal_thread_t *_osal_thread_self(void) {
+
+	if (_osal_thread == NULL) {
+		pthread_condattr_t attr ;
+
+		osalInit () ;
+		_osal_thread = calloc (1, sizeof (osal_thread_t)) ;
+		osalDbgAssert(_osal_thread != NULL, "out of memory");
+		(void)pthread_condattr_init (&attr) ;
+		(void)pthread_condattr_setclock (&attr, CLOCK_MONOTONIC) ;
+		(void)pthread_cond_init (&_osal_thread->cond, &attr) ;
+		(void)pthread_condattr_destroy (&attr) ;
+		(void)pthread_setspecific (_osal_thread_key, _osal_thread) ;
+	}
+	return _osal_thread ;
+}
+
+/**
+ * @brief   Realtime counter, host monotonic clock in nanoseconds.
+ *
+ * @xclass
+ */
+rtcnt_t chSysGetRealtimeCounterX(void) {
+
+	return (rtcnt_t)osal_monotonic_ns () ;
+}
+
+bool chSysIsCounterWithinX(rtcnt_t cnt, rtcnt_t start, rtcnt_t end) {
+
+	return (bool)(((rtcnt_t)cnt - (rtcnt_t)start) <
+	              ((rtcnt_t)end - (rtcnt_t)start));
+}
+
+void chSysPolledDelayX(rtcnt_t cycles) {
+	rtcnt_t start = chSysGetRealtimeCounterX();
+	rtcnt_t end  = start + cycles;
+
+	while (chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end)) {
+	}
+}
+
+/**
+ * @brief   Current system time.
+ * @details Returns the number of system ticks since the @p osalInit()
+ *          invocation.
+ *
+ * @return              The system time in ticks.
+ *
+ * @xclass
+ */
+systime_t osalOsGetSystemTimeX(void) {
+	uint64_t epoch ;
+
+	osalInit () ;
+	epoch = ((uint64_t)_osal_epoch.tv_sec * 1000000000ULL) +
+	        (uint64_t)_osal_epoch.tv_nsec ;
+	return (systime_t)(((osal_monotonic_ns () - epoch) * OSAL_ST_FREQUENCY) /
+	                   1000000000ULL) ;
+}
+
+/**
+ * @brief   Suspends the invoking thread for the specified time.
+ *
+ * @param[in] delay     the delay in system ticks
+ *
+ * @api
+ */
+void osalThreadSleep(sysinterval_t delay) {
+	uint64_t ns = ((uint64_t)delay * 1000000000ULL) / OSAL_ST_FREQUENCY ;
+	struct timespec ts ;
+
+	ts.tv_sec  = (time_t)(ns / 1000000000ULL) ;
+	ts.tv_nsec = (long)(ns % 1000000000ULL) ;
+	while (nanosleep (&ts, &ts) != 0 && errno == EINTR) {
+	}
+}
+
+/**
+ * @brief   Sends the current thread sleeping and sets a reference variable.
+ *
+ * @param[in] trp       a pointer to a thread reference object
+ * @param[in] timeout   the timeout in system ticks, the special values are
+ *                      handled as follow:
+ *                      - @a TIME_INFINITE the thread enters an infinite sleep
+ *                        state.
+ *                      - @a TIME_IMMEDIATE the thread is not enqueued and
+ *                        the function returns @p MSG_TIMEOUT as if a timeout
+ *                        occurred.
+ *                      .
+ * @return              The wake up message.
+ * @retval MSG_TIMEOUT  if the operation timed out.
+ *
+ * @sclass
+ */
+msg_t osalThreadSuspendTimeoutS(thread_reference_t *trp,
+                                sysinterval_t timeout) {
+	osal_thread_t *tp = _osal_thread_self () ;
+	struct timespec deadline ;
+
+	if (timeout == TIME_IMMEDIATE) {
+		return MSG_TIMEOUT ;
+	}
+
+	if (timeout != TIME_INFINITE) {
+		uint64_t ns = osal_monotonic_ns () +
+		              (((uint64_t)timeout * 1000000000ULL) / OSAL_ST_FREQUENCY) ;
+
+		deadline.tv_sec  = (time_t)(ns / 1000000000ULL) ;
+		deadline.tv_nsec = (long)(ns % 1000000000ULL) ;
+	}
+
+	tp->signaled = false ;
+	*trp = tp ;
+	_osal_lock_owner = false ;
+	while (!tp->signaled) {
+		if (timeout == TIME_INFINITE) {
+			(void)pthread_cond_wait (&tp->cond, &_osal_lock) ;
+		}
+		else if (pthread_cond_timedwait (&tp->cond, &_osal_lock,
+		                                 &deadline) == ETIMEDOUT) {
+			break ;
+		}
+	}
+	_osal_lock_owner = true ;
+
+	if (!tp->signaled) {
+		*trp = NULL ;
+		return MSG_TIMEOUT ;
+	}
+	return tp->msg ;
+}
+
+/**
+ * @brief   Enqueues the caller thread.
+ * @details The caller thread is enqueued and put to sleep until it is
+ *          dequeued or the specified timeouts expires.
+ *
+ * @param[in] tqp       pointer to the threads queue object
+ * @param[in] timeout   the timeout in system ticks
+ * @return              The message from @p osalQueueWakeupOneI() or
+ *                      @p osalQueueWakeupAllI() functions.
+ * @retval MSG_TIMEOUT  if the thread has not been dequeued within the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+msg_t osalThreadEnqueueTimeoutS(threads_queue_t *tqp,
+                                sysinterval_t timeout) {
+	osal_waiter_t w ;
+	msg_t msg ;
+
+	if (timeout == TIME_IMMEDIATE) {
+		return MSG_TIMEOUT ;
+	}
+
+	w.next = NULL ;
+	if (tqp->tail == NULL) {
+		tqp->head = &w ;
+	}
+	else {
+		tqp->tail->next = &w ;
+	}
+	tqp->tail = &w ;
+
+	msg = osalThreadSuspendTimeoutS (&w.thread, timeout) ;
+	if (msg == MSG_TIMEOUT) {
+		/* Timeout, the waiter is still linked.*/
+		osal_threads_queue_remove (tqp, &w) ;
+	}
+	return msg ;
+}
+
+/**
+ * @brief   Initializes s @p mutex_t object.
+ *
+ * @param[out] mp       pointer to the @p mutex_t object
+ *
+ * @init
+ */
+void osalMutexObjectInit(mutex_t *mp) {
+	pthread_mutexattr_t attr ;
+
+	(void)pthread_mutexattr_init (&attr) ;
+	(void)pthread_mutexattr_settype (&attr, PTHREAD_MUTEX_RECURSIVE) ;
+	(void)pthread_mutex_init (mp, &attr) ;
+	(void)pthread_mutexattr_destroy (&attr) ;
+}
+
+/** @} */
@@ -0,0 +1,809 @@
+/*
+    Copyright (C) 2015-2024, Navaro, All Rights Reserved
+    SPDX-License-Identifier: MIT
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+/**
+ * @file    osal.h
+ * @brief   OSAL module header, POSIX threads host simulation.
+ * @details The system critical zone is a single process-wide mutex,
+ *          simulated interrupt sources are host threads taking the same
+ *          mutex through the ISR-class lock functions.
+ * @note    Only the OSAL layer is provided. Peripheral register models
+ *          and host builds of the STM32 LLDs are not part of this port,
+ *          they require the HAL core and the CMSIS device headers which
+ *          are outside this tree.
+ *
+ * @addtogroup OSAL
+ * @{
+ */
+
+#ifndef OSAL_H
+#define OSAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "halconf.h"
+
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Common constants
+ * @{
+ */
+#if !defined(FALSE) || defined(__DOXYGEN__)
+#define FALSE                               0
+#endif
+
+#if !defined(TRUE) || defined(__DOXYGEN__)
+#define TRUE                                (1)
+#endif
+
+#define OSAL_SUCCESS                        FALSE
+#define OSAL_FAILED                         TRUE
+/** @} */
+
+/**
+ * @name    Messages
+ * @{
+ */
+#define MSG_OK                              0
+#define MSG_RESET                           -2
+#define MSG_TIMEOUT                         -1
+#define MSG_NAK                         	-3
+/** @} */
+
+/**
+ * @name    Special time constants
+ * @{
+ */
+#define TIME_IMMEDIATE                      ((sysinterval_t)0)
+#define TIME_INFINITE                       ((sysinterval_t)-1)
+/** @} */
+
+/**
+ * @name    Systick modes.
+ * @{
+ */
+#define OSAL_ST_MODE_NONE                   0
+#define OSAL_ST_MODE_PERIODIC               1
+#define OSAL_ST_MODE_FREERUNNING            2
+/** @} */
+
+/**
+ * @name    Systick parameters.
+ * @{
+ */
+/**
+ * @brief   Size in bits of the @p systick_t type.
+ */
+#define OSAL_ST_RESOLUTION                  32
+
+/**
+ * @brief   Required systick frequency or resolution.
+ */
+#define OSAL_ST_FREQUENCY                   1000
+
+/**
+ * @brief   Systick mode required by the underlying OS.
+ */
+#define OSAL_ST_MODE                        OSAL_ST_MODE_NONE
+/** @} */
+
+/**
+ * @brief   Frequency of the realtime counter.
+ * @details The realtime counter is the host monotonic clock in
+ *          nanoseconds.
+ */
+#define OSAL_RTC_FREQUENCY                  1000000000UL
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (OSAL_ST_RESOLUTION != 16) && (OSAL_ST_RESOLUTION != 32)
+#error "invalid OSAL_ST_RESOLUTION, must be 16 or 32"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a system status word.
+ */
+typedef uint32_t syssts_t;
+
+/**
+ * @brief   Type of a message.
+ */
+typedef int32_t msg_t;
+
+/**
+ * @brief   Type of system time counter.
+ */
+typedef uint32_t systime_t;
+
+/**
+ * @brief   Type of system time interval.
+ */
+typedef uint32_t sysinterval_t;
+
+/**
+ * @brief   Type of realtime counter.
+ */
+typedef uint32_t rtcnt_t;
+
+/**
+ * @brief   Type of an host thread wait object.
+ * @details One instance exists for each host thread using the OSAL.
+ */
+typedef struct osal_thread {
+  /**
+   * @brief   Condition signaled on wake up, used with the system mutex.
+   */
+  pthread_cond_t            cond;
+  /**
+   * @brief   Wake up pending.
+   */
+  bool                      signaled;
+  /**
+   * @brief   Wake up message.
+   */
+  msg_t                     msg;
+} osal_thread_t;
+
+/**
+ * @brief   Type of a thread reference.
+ */
+typedef osal_thread_t * thread_reference_t;
+
+/**
+ * @brief   Type of an event flags mask.
+ */
+typedef uint32_t eventflags_t;
+
+/**
+ * @brief   Type of an event flags object.
+ * @note    Retrieval and clearing of the flags are not defined in this
+ *          API and are implementation-dependent.
+ */
+typedef struct {
+  /**
+   * @brief   Flags stored into the object.
+   */
+  volatile eventflags_t     flags;
+} event_source_t;
+
+/**
+ * @brief   Type of a mutex.
+ */
+typedef pthread_mutex_t mutex_t;
+
+/**
+ * @brief   Type of a thread queue waiter.
+ * @details Waiters are allocated on the stack of the waiting thread and
+ *          stay linked to the queue for the duration of the wait.
+ */
+typedef struct osal_waiter {
+  /**
+   * @brief   Next waiter in FIFO order.
+   */
+  struct osal_waiter        *next;
+  /**
+   * @brief   Waiting thread, @p NULL once dequeued.
+   */
+  thread_reference_t        thread;
+} osal_waiter_t;
+
+/**
+ * @brief   Type of a thread queue.
+ * @details A thread queue is a queue of sleeping threads, queued threads
+ *          can be dequeued one at time or all together.
+ */
+typedef struct {
+  /**
+   * @brief   First waiter, @p NULL if the queue is empty.
+   */
+  osal_waiter_t             *head;
+  /**
+   * @brief   Last waiter.
+   */
+  osal_waiter_t             *tail;
+} threads_queue_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Debug related macros
+ * @{
+ */
+/**
+ * @brief   Condition assertion.
+ * @details If the condition check fails then the OSAL panics with a
+ *          message and halts.
+ *
+ * @param[in] c         the condition to be verified to be true
+ * @param[in] remark    a remark string
+ *
+ * @api
+ */
+#define osalDbgAssert(c, remark) do {                                       \
+  if (!(c)) {                                                               \
+    osalSysHalt(remark);                                                    \
+  }                                                                         \
+} while (false)
+
+/**
+ * @brief   Function parameters check.
+ * @details If the condition check fails then the OSAL panics and halts.
+ *
+ * @param[in] c         the condition to be verified to be true
+ *
+ * @api
+ */
+#define osalDbgCheck(c) osalDbgAssert(c, __func__)
+
+/**
+ * @brief   I-Class state check.
+ */
+#define osalDbgCheckClassI() osalDbgAssert(_osal_lock_owner, "not locked")
+
+/**
+ * @brief   S-Class state check.
+ */
+#define osalDbgCheckClassS() osalDbgAssert(_osal_lock_owner, "not locked")
+/** @} */
+
+/**
+ * @name    IRQ service routines wrappers
+ * @{
+ */
+/**
+ * @brief   Priority level verification macro.
+ */
+#define OSAL_IRQ_IS_VALID_PRIORITY(n) 1
+
+/**
+ * @brief   IRQ prologue code.
+ * @details This macro must be inserted at the start of all IRQ handlers.
+ */
+#define OSAL_IRQ_PROLOGUE()
+
+/**
+ * @brief   IRQ epilogue code.
+ * @details This macro must be inserted at the end of all IRQ handlers.
+ */
+#define OSAL_IRQ_EPILOGUE()
+
+/**
+ * @brief   IRQ handler function declaration.
+ * @details This macro hides the details of an ISR function declaration,
+ *          simulated interrupts invoke the handler from a host thread.
+ *
+ * @param[in] id        a vector name as defined in @p vectors.s
+ */
+#define OSAL_IRQ_HANDLER(id) void id(void)
+/** @} */
+
+/**
+ * @name    Time conversion utilities
+ * @{
+ */
+/**
+ * @brief   Seconds to system ticks.
+ *
+ * @param[in] secs      number of seconds
+ * @return              The number of ticks.
+ *
+ * @api
+ */
+#define OSAL_S2I(sec) ((systime_t)((uint32_t)(sec) * (uint32_t)OSAL_ST_FREQUENCY))
+
+/**
+ * @brief   Milliseconds to system ticks.
+ * @note    The result is rounded upward to the next tick boundary.
+ *
+ * @param[in] msecs     number of milliseconds
+ * @return              The number of ticks.
+ *
+ * @api
+ */
+#define OSAL_MS2I(msec) ((systime_t)(((((uint32_t)(msec)) *    \
+        ((uint32_t)OSAL_ST_FREQUENCY)) + 999UL) / 1000UL))
+
+/**
+ * @brief   Microseconds to system ticks.
+ * @note    The result is rounded upward to the next tick boundary.
+ *
+ * @param[in] usecs     number of microseconds
+ * @return              The number of ticks.
+ *
+ * @api
+ */
+#define OSAL_US2I(usec) ((systime_t)(((((uint32_t)(usec)) *   \
+        ((uint32_t)OSAL_ST_FREQUENCY)) + 999999UL) / 1000000UL))
+/** @} */
+
+/**
+ * @name    Time conversion utilities for the realtime counter
+ * @{
+ */
+/**
+ * @brief   Seconds to realtime counter.
+ *
+ * @param[in] freq      clock frequency, in Hz, of the realtime counter
+ * @param[in] sec       number of seconds
+ * @return              The number of cycles.
+ *
+ * @api
+ */
+#define OSAL_S2RTC(freq, sec) ((rtcnt_t)((freq) * (sec)))
+
+/**
+ * @brief   Milliseconds to realtime counter.
+ * @note    The result is rounded upward to the next millisecond boundary.
+ *
+ * @param[in] freq      clock frequency, in Hz, of the realtime counter
+ * @param[in] msec      number of milliseconds
+ * @return              The number of cycles.
+ *
+ * @api
+ */
+#define OSAL_MS2RTC(freq, msec)                                             \
+  ((rtcnt_t)((((freq) + 999UL) / 1000UL) * (msec)))
+
+/**
+ * @brief   Microseconds to realtime counter.
+ * @note    The result is rounded upward to the next microsecond boundary.
+ *
+ * @param[in] freq      clock frequency, in Hz, of the realtime counter
+ * @param[in] usec      number of microseconds
+ * @return              The number of cycles.
+ *
+ * @api
+ */
+#define OSAL_US2RTC(freq, usec)                                             \
+  ((rtcnt_t)((((freq) + 999999UL) / 1000000UL) * (usec)))
+/** @} */
+
+/**
+ * @name    Sleep macros using absolute time
+ * @{
+ */
+#define osalThreadSleepSeconds(sec) osalThreadSleep(OSAL_S2I(sec))
+#define osalThreadSleepMilliseconds(msec) osalThreadSleep(OSAL_MS2I(msec))
+#define osalThreadSleepMicroseconds(usec) osalThreadSleep(OSAL_US2I(usec))
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern pthread_mutex_t _osal_lock ;
+extern _Thread_local bool _osal_lock_owner ;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void osalInit(void);
+  void osalSysHalt(const char *reason);
+  osal_thread_t *_osal_thread_self(void);
+  rtcnt_t chSysGetRealtimeCounterX(void);
+  bool chSysIsCounterWithinX(rtcnt_t cnt, rtcnt_t start, rtcnt_t end);
+  void chSysPolledDelayX(rtcnt_t cycles);
+  systime_t osalOsGetSystemTimeX(void);
+  void osalThreadSleep(sysinterval_t delay);
+  msg_t osalThreadSuspendTimeoutS(thread_reference_t *trp,
+                                  sysinterval_t timeout);
+  msg_t osalThreadEnqueueTimeoutS(threads_queue_t *tqp,
+                                  sysinterval_t timeout);
+  void osalMutexObjectInit(mutex_t *mp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Enters a critical zone from thread context.
+ * @note    This function cannot be used for reentrant critical zones.
+ *
+ * @special
+ */
+static inline void osalSysLock(void) {
+
+	(void)pthread_mutex_lock (&_osal_lock) ;
+	_osal_lock_owner = true ;
+}
+
+/**
+ * @brief   Leaves a critical zone from thread context.
+ * @note    This function cannot be used for reentrant critical zones.
+ *
+ * @special
+ */
+static inline void osalSysUnlock(void) {
+
+	_osal_lock_owner = false ;
+	(void)pthread_mutex_unlock (&_osal_lock) ;
+}
+
+/**
+ * @brief   Enters a critical zone from ISR context.
+ * @note    Simulated interrupts are host threads, the same mutex is used.
+ *
+ * @special
+ */
+static inline void osalSysLockFromISR(void) {
+
+	osalSysLock () ;
+}
+
+/**
+ * @brief   Leaves a critical zone from ISR context.
+ *
+ * @special
+ */
+static inline void osalSysUnlockFromISR(void) {
+
+	osalSysUnlock () ;
+}
+
+/**
+ * @brief   Disables interrupts globally.
+ * @note    Simulated interrupts are excluded by the system mutex.
+ *
+ * @special
+ */
+static inline void osalSysDisable(void) {
+
+	osalSysLock () ;
+}
+
+/**
+ * @brief   Enables interrupts globally.
+ *
+ * @special
+ */
+static inline void osalSysEnable(void) {
+
+	osalSysUnlock () ;
+}
+
+/**
+ * @brief   Returns the execution status and enters a critical zone.
+ * @details This functions enters into a critical zone and can be called
+ *          from any context.
+ * @post    The system is in a critical zone.
+ *
+ * @return              The previous system status, the encoding of this
+ *                      status word is architecture-dependent and opaque.
+ *
+ * @xclass
+ */
+static inline syssts_t osalSysGetStatusAndLockX(void) {
+
+	if (_osal_lock_owner) {
+		return 1 ;
+	}
+	osalSysLock () ;
+	return 0 ;
+}
+
+/**
+ * @brief   Restores the specified execution status and leaves a critical zone.
+ *
+ * @param[in] sts       the system status to be restored.
+ *
+ * @xclass
+ */
+static inline void osalSysRestoreStatusX(syssts_t sts) {
+
+	if (!sts) {
+		osalSysUnlock () ;
+	}
+}
+
+/**
+ * @brief   Polled delay.
+ * @note    The real delay is always few cycles in excess of the specified
+ *          value.
+ *
+ * @param[in] cycles    number of realtime counter cycles, nanoseconds
+ *
+ * @xclass
+ */
+static inline void osalSysPolledDelayX(rtcnt_t cycles) {
+
+	chSysPolledDelayX(cycles);
+}
+
+/**
+ * @brief   Checks if a reschedule is required and performs it.
+ * @note    Host threads are woken directly, nothing to do.
+ *
+ * @sclass
+ */
+static inline void osalOsRescheduleS(void) {
+
+}
+
+/**
+ * @brief   Adds an interval to a system time returning a system time.
+ *
+ * @param[in] systime   base system time
+ * @param[in] interval  interval to be added
+ * @return              The new system time.
+ *
+ * @xclass
+ */
+static inline systime_t osalTimeAddX(systime_t systime,
+                                     sysinterval_t interval) {
+
+	return systime + interval;
+}
+
+/**
+ * @brief   Subtracts two system times returning an interval.
+ *
+ * @param[in] start     first system time
+ * @param[in] end       second system time
+ * @return              The interval representing the time difference.
+ *
+ * @xclass
+ */
+static inline sysinterval_t osalTimeDiffX(systime_t start, systime_t end) {
+
+	return end - start;
+}
+
+/**
+ * @brief   Checks if the specified time is within the specified time window.
+ *
+ * @param[in] time      the time to be verified
+ * @param[in] start     the start of the time window (inclusive)
+ * @param[in] end       the end of the time window (non inclusive)
+ * @retval true         current time within the specified time window.
+ * @retval false        current time not within the specified time window.
+ *
+ * @xclass
+ */
+static inline bool osalTimeIsInRangeX(systime_t time,
+                                      systime_t start,
+                                      systime_t end) {
+
+	return (bool)((systime_t)(time - start) < (systime_t)(end - start)) ;
+}
+
+/**
+ * @brief   Suspends the invoking thread for the specified time.
+ *
+ * @param[in] delay     the delay in system ticks
+ *
+ * @sclass
+ */
+static inline void osalThreadSleepS(sysinterval_t delay) {
+
+	osalSysUnlock () ;
+	osalThreadSleep (delay) ;
+	osalSysLock () ;
+}
+
+/**
+ * @brief   Sends the current thread sleeping and sets a reference variable.
+ *
+ * @param[in] trp       a pointer to a thread reference object
+ * @return              The wake up message.
+ *
+ * @sclass
+ */
+static inline msg_t osalThreadSuspendS(thread_reference_t *trp) {
+
+	return osalThreadSuspendTimeoutS (trp, TIME_INFINITE) ;
+}
+
+/**
+ * @brief   Wakes up a thread waiting on a thread reference object.
+ *
+ * @param[in] trp       a pointer to a thread reference object
+ * @param[in] msg       the message code
+ *
+ * @iclass
+ */
+static inline void osalThreadResumeI(thread_reference_t *trp, msg_t msg) {
+
+	if (*trp != NULL) {
+		osal_thread_t *tp = *trp ;
+
+		*trp = NULL ;
+		tp->msg      = msg ;
+		tp->signaled = true ;
+		(void)pthread_cond_signal (&tp->cond) ;
+	}
+}
+
+/**
+ * @brief   Wakes up a thread waiting on a thread reference object.
+ *
+ * @param[in] trp       a pointer to a thread reference object
+ * @param[in] msg       the message code
+ *
+ * @sclass
+ */
+static inline void osalThreadResumeS(thread_reference_t *trp, msg_t msg) {
+
+	osalThreadResumeI (trp, msg) ;
+}
+
+/**
+ * @brief   Initializes a threads queue object.
+ *
+ * @param[out] tqp      pointer to the threads queue object
+ *
+ * @init
+ */
+static inline void osalThreadQueueObjectInit(threads_queue_t *tqp) {
+
+	tqp->head = NULL ;
+	tqp->tail = NULL ;
+}
+
+/**
+ * @brief   Wakes up a dequeued waiter.
+ *
+ * @param[in] wp        pointer to the waiter
+ * @param[in] msg       the message code
+ *
+ * @notapi
+ */
+static inline void _osal_waiter_wakeupI(osal_waiter_t *wp, msg_t msg) {
+
+	osalThreadResumeI (&wp->thread, msg) ;
+}
+
+/**
+ * @brief   Dequeues and wakes up one thread from the queue, if any.
+ *
+ * @param[in] tqp       pointer to the threads queue object
+ * @param[in] msg       the message code
+ *
+ * @iclass
+ */
+static inline void osalThreadDequeueNextI(threads_queue_t *tqp, msg_t msg) {
+	osal_waiter_t *wp = tqp->head ;
+
+	if (wp != NULL) {
+		tqp->head = wp->next ;
+		if (tqp->head == NULL) {
+			tqp->tail = NULL ;
+		}
+		_osal_waiter_wakeupI (wp, msg) ;
+	}
+}
+
+/**
+ * @brief   Dequeues and wakes up all threads from the queue.
+ *
+ * @param[in] tqp       pointer to the threads queue object
+ * @param[in] msg       the message code
+ *
+ * @iclass
+ */
+static inline void osalThreadDequeueAllI(threads_queue_t *tqp, msg_t msg) {
+	osal_waiter_t *wp = tqp->head ;
+
+	tqp->head = NULL ;
+	tqp->tail = NULL ;
+	while (wp != NULL) {
+		osal_waiter_t *next = wp->next ;
+
+		_osal_waiter_wakeupI (wp, msg) ;
+		wp = next ;
+	}
+}
+
+/**
+ * @brief   Initializes an event flags object.
+ *
+ * @param[out] esp      pointer to the event flags object
+ *
+ * @init
+ */
+static inline void osalEventObjectInit(event_source_t *esp) {
+
+	esp->flags = 0U ;
+}
+
+/**
+ * @brief   Add flags to an event source object.
+ *
+ * @param[in] esp       pointer to the event flags object
+ * @param[in] flags     flags to be ORed to the flags mask
+ *
+ * @iclass
+ */
+static inline void osalEventBroadcastFlagsI(event_source_t *esp,
+                                            eventflags_t flags) {
+
+	esp->flags |= flags ;
+}
+
+/**
+ * @brief   Add flags to an event source object.
+ *
+ * @param[in] esp       pointer to the event flags object
+ * @param[in] flags     flags to be ORed to the flags mask
+ *
+ * @api
+ */
+static inline void osalEventBroadcastFlags(event_source_t *esp,
+                                           eventflags_t flags) {
+
+	osalSysLock () ;
+	osalEventBroadcastFlagsI (esp, flags) ;
+	osalSysUnlock () ;
+}
+
+/**
+ * @brief   Locks the specified mutex.
+ *
+ * @param[in,out] mp    pointer to the @p mutex_t object
+ *
+ * @api
+ */
+static inline void osalMutexLock(mutex_t *mp) {
+
+	(void)pthread_mutex_lock (mp) ;
+}
+
+/**
+ * @brief   Unlocks the specified mutex.
+ *
+ * @param[in,out] mp    pointer to the @p mutex_t object
+ *
+ * @api
+ */
+static inline void osalMutexUnlock(mutex_t *mp) {
+
+	(void)pthread_mutex_unlock (mp) ;
+}
+
+#endif /* OSAL_H */
+
+/** @} */
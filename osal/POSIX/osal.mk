@@ -0,0 +1,5 @@
+# OSAL files.
+OSALSRC += $(PRJROOT)/pdu-platform/hal/osal/POSIX/osal.c
+
+# Required include directories
+OSALINC += $(PRJROOT)/pdu-platform/hal/osal/POSIX
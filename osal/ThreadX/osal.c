@@ -74,4 +74,36 @@ void chSysPolledDelayX(rtcnt_t cycles) {
 }
 
 
+/**
+ * @brief   Removes a waiter from a threads queue.
+ * @note    Only used on timeout, the dequeue paths unlink from the head.
+ *
+ * @param[in] tqp       pointer to the threads queue object
+ * @param[in] wp        pointer to the waiter to be removed
+ *
+ * @notapi
+ */
+void _osal_threads_queue_remove(threads_queue_t *tqp, osal_waiter_t *wp) {
+  osal_waiter_t *prev = NULL;
+  osal_waiter_t *cur = tqp->head;
+
+  while ((cur != NULL) && (cur != wp)) {
+    prev = cur;
+    cur  = cur->next;
+  }
+  if (cur == NULL) {
+    return;
+  }
+
+  if (prev == NULL) {
+    tqp->head = wp->next;
+  }
+  else {
+    prev->next = wp->next;
+  }
+  if (tqp->tail == wp) {
+    tqp->tail = prev;
+  }
+}
+
 /** @} */
@@ -205,14 +205,43 @@ typedef TX_MUTEX mutex_t;
 
 
 #if 1
+/**
+ * @brief   Type of a thread queue waiter.
+ * @details Waiters are allocated on the stack of the waiting thread and
+ *          stay linked to the queue for the duration of the wait.
+ */
+typedef struct osal_waiter {
+  /**
+   * @brief   Next waiter in FIFO order.
+   */
+  struct osal_waiter        *next;
+  /**
+   * @brief   Waiting thread, @p NULL once dequeued.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Message delivered by the dequeue operation.
+   */
+  volatile msg_t            msg;
+} osal_waiter_t;
+
 /**
  * @brief   Type of a thread queue.
  * @details A thread queue is a queue of sleeping threads, queued threads
  *          can be dequeued one at time or all together.
- * @note    In this implementation it is implemented as a single reference
- *          because there are no real threads.
- */
-typedef TX_SEMAPHORE threads_queue_t;
+ * @note    In this implementation it is a FIFO list of waiters, each
+ *          waiter is woken individually and receives the message code.
+ */
+typedef struct {
+  /**
+   * @brief   First waiter, @p NULL if the queue is empty.
+   */
+  osal_waiter_t             *head;
+  /**
+   * @brief   Last waiter.
+   */
+  osal_waiter_t             *tail;
+} threads_queue_t;
 #endif
 
 /*===========================================================================*/
@@ -436,6 +465,7 @@ extern "C" {
 #endif
 
  void chSysPolledDelayX(rtcnt_t cycles) ;
+ void _osal_threads_queue_remove(threads_queue_t *tqp, osal_waiter_t *wp) ;
 
 #ifdef __cplusplus
 }
@@ -796,7 +826,8 @@ static inline void osalThreadResumeS(thread_reference_t *trp, msg_t msg) {
  * @init
  */
 static inline void osalThreadQueueObjectInit(threads_queue_t *tqp) {
-	tx_semaphore_create (tqp, "osal", 0) ;
+	tqp->head = NULL ;
+	tqp->tail = NULL ;
 }
 
 /**
@@ -824,11 +855,47 @@ static inline void osalThreadQueueObjectInit(threads_queue_t *tqp) {
  */
 static inline msg_t osalThreadEnqueueTimeoutS(threads_queue_t *tqp,
                                               sysinterval_t timeout) {
-//uint32_t irq = tx_interrupt_control (TX_INT_ENABLE) ;
-	msg_t r = tx_semaphore_get (tqp, timeout) == TX_SUCCESS ?
-			MSG_OK : MSG_TIMEOUT ;
-//tx_interrupt_control (irq) ;
-	return r ;
+	osal_waiter_t w ;
+
+	if (timeout == TIME_IMMEDIATE) {
+		return MSG_TIMEOUT ;
+	}
+
+	w.next   = NULL ;
+	w.thread = os_thread_current () ;
+	w.msg    = MSG_TIMEOUT ;
+	if (tqp->tail == NULL) {
+		tqp->head = &w ;
+	}
+	else {
+		tqp->tail->next = &w ;
+	}
+	tqp->tail = &w ;
+
+	os_thread_wait (TIME_IMMEDIATE) ;
+	(void)os_thread_wait (timeout) ;
+
+	if (w.thread != NULL) {
+		/* Timeout, the waiter is still linked.*/
+		_osal_threads_queue_remove (tqp, &w) ;
+	}
+	return w.msg ;
+}
+
+/**
+ * @brief   Wakes up a dequeued waiter.
+ *
+ * @param[in] wp        pointer to the waiter
+ * @param[in] msg       the message code
+ *
+ * @notapi
+ */
+static inline void _osal_waiter_wakeupI(osal_waiter_t *wp, msg_t msg) {
+	thread_reference_t thread = wp->thread ;
+
+	wp->msg    = msg ;
+	wp->thread = NULL ;
+	os_thread_notify (&thread, msg) ;
 }
 
 /**
@@ -840,11 +907,21 @@ static inline msg_t osalThreadEnqueueTimeoutS(threads_queue_t *tqp,
  * @iclass
  */
 static inline void osalThreadDequeueNextI(threads_queue_t *tqp, msg_t msg) {
-	tx_semaphore_ceiling_put (tqp, 1) ;
+	osal_waiter_t *wp = tqp->head ;
+
+	if (wp != NULL) {
+		tqp->head = wp->next ;
+		if (tqp->head == NULL) {
+			tqp->tail = NULL ;
+		}
+		_osal_waiter_wakeupI (wp, msg) ;
+	}
 }
 
 /**
  * @brief   Dequeues and wakes up all threads from the queue.
+ * @details The list is detached at once, then each waiter receives the
+ *          message, the time spent is linear in the number of waiters.
  *
  * @param[in] tqp       pointer to the threads queue object
  * @param[in] msg       the message code
@@ -852,11 +929,15 @@ static inline void osalThreadDequeueNextI(threads_queue_t *tqp, msg_t msg) {
  * @iclass
  */
 static inline void osalThreadDequeueAllI(threads_queue_t *tqp, msg_t msg) {
-	ULONG suspended_count = 0 ;
-	UINT status = tx_semaphore_info_get(tqp, 0,0, 0, &suspended_count, 0) ;
-	while ((status == TX_SUCCESS) && suspended_count) {
-		tx_semaphore_ceiling_put (tqp, 1) ;
-		status = tx_semaphore_info_get(tqp, 0,0, 0, &suspended_count, 0) ;
+	osal_waiter_t *wp = tqp->head ;
+
+	tqp->head = NULL ;
+	tqp->tail = NULL ;
+	while (wp != NULL) {
+		osal_waiter_t *next = wp->next ;
+
+		_osal_waiter_wakeupI (wp, msg) ;
+		wp = next ;
 	}
 }
 
@@ -44,6 +44,27 @@
   STM32_DMA_GETCHANNEL(STM32_CRY_HASH1_DMA_STREAM,                          \
                        STM32_HASH1_DMA_CHN)
 
+/* HASH_CSRx registers in use when not in HMAC mode.*/
+#define HASH_CSR_NUM_HASH                   38U
+
+#if defined(CRYP_CR_NPBLB)
+#define CRYP_CR_AEAD_MASK                   (CRYP_CR_GCM_CCMPH | CRYP_CR_NPBLB)
+#else
+#define CRYP_CR_AEAD_MASK                   CRYP_CR_GCM_CCMPH
+#endif
+
+/* Synchronous operations must not be started while queued jobs are using
+   the unit, the ISRs would route their completion to the job handlers.*/
+#if STM32_CRY_USE_QUEUE == TRUE
+#define CRYP_ASSERT_NO_JOBS(cryp)                                           \
+  osalDbgAssert((cryp)->cryp_job_head == NULL, "jobs pending")
+#define HASH_ASSERT_NO_JOBS(cryp)                                           \
+  osalDbgAssert((cryp)->hash_job_head == NULL, "jobs pending")
+#else
+#define CRYP_ASSERT_NO_JOBS(cryp)           (void)(cryp)
+#define HASH_ASSERT_NO_JOBS(cryp)           (void)(cryp)
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -63,15 +84,12 @@ CRYDriver CRYD1;
 
 #if (STM32_CRY_USE_CRYP1 == TRUE) || defined (__DOXYGEN__)
 /**
- * @brief   Setting AES key for encryption.
+ * @brief   Loading the transient key in the key registers.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
- * @param[in] algomode          algorithm mode field of CR register
  */
-static inline void cryp_set_key_encrypt(CRYDriver *cryp, uint32_t algomode) {
-  uint32_t cr;
+static inline void cryp_load_key(CRYDriver *cryp) {
 
-  /* Loading key data.*/
   CRYP->K0LR = cryp->cryp_k[0];
   CRYP->K0RR = cryp->cryp_k[1];
   CRYP->K1LR = cryp->cryp_k[2];
@@ -80,18 +98,36 @@ static inline void cryp_set_key_encrypt(CRYDriver *cryp, uint32_t algomode) {
   CRYP->K2RR = cryp->cryp_k[5];
   CRYP->K3LR = cryp->cryp_k[6];
   CRYP->K3RR = cryp->cryp_k[7];
+}
+
+/**
+ * @brief   Setting AES key for encryption.
+ * @note    The key registers are not touched if they already contain the
+ *          encryption key, only the mode is updated.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] algomode          algorithm mode field of CR register
+ */
+static inline void cryp_set_key_encrypt(CRYDriver *cryp, uint32_t algomode) {
+  uint32_t cr;
+
+  /* Loading key data.*/
+  if (cryp->cryp_ktype != cryp_key_aes_encrypt) {
+    cryp_load_key(cryp);
+    cryp->cryp_ktype = cryp_key_aes_encrypt;
+  }
 
   /* Setting up then starting operation.*/
   cr  = CRYP->CR;
   cr &= ~(CRYP_CR_KEYSIZE_Msk | CRYP_CR_ALGOMODE_Msk | CRYP_CR_ALGODIR_Msk);
   cr |= cryp->cryp_ksize | algomode | CRYP_CR_CRYPEN;
   CRYP->CR = cr;
-
-  cryp->cryp_ktype = cryp_key_aes_encrypt;
 }
 
 /**
  * @brief   Setting AES key for decryption.
+ * @note    The key preparation is skipped if the decryption key is still
+ *          in place from a previous operation.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[in] algomode          algorithm field of CR register
@@ -100,8 +136,10 @@ static inline void cryp_set_key_decrypt(CRYDriver *cryp, uint32_t algomode) {
   uint32_t cr;
 
   /* Loading key data then doing transformation for decrypt.*/
-  cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_KEY);
-  while ((CRYP->CR & CRYP_CR_CRYPEN) != 0U) {
+  if (cryp->cryp_ktype != cryp_key_aes_decrypt) {
+    cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_KEY);
+    while ((CRYP->CR & CRYP_CR_CRYPEN) != 0U) {
+    }
   }
 
   /* Setting up then starting operation.*/
@@ -130,22 +168,32 @@ static inline void cryp_set_iv(CRYDriver *cryp, const uint8_t *iv) {
 }
 
 /**
- * @brief   Performs a CRYP operation using DMA.
+ * @brief   Waits for the CRYP to process all the pushed data.
+ * @note    BUSY alone is not enough, it can read zero while blocks are
+ *          still waiting in the input FIFO.
+ */
+static inline void cryp_wait_idle(void) {
+
+  while ((CRYP->SR & CRYP_SR_IFEM) == 0U) {
+  }
+  while ((CRYP->SR & CRYP_SR_BUSY) != 0U) {
+  }
+}
+
+/**
+ * @brief   Moves data through the CRYP using DMA or polling.
+ * @note    The unit is left enabled.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[in] size              size of both buffers, this number must be a
  *                              multiple of 16
  * @param[in] in                input buffer
  * @param[out] out              output buffer
- * @return                      The operation status.
- * @retval CRY_NOERROR          if the operation succeeded.
- * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
- *                              dependent.
  */
-static cryerror_t cryp_do_transfer(CRYDriver *cryp,
-                                   size_t size,
-                                   const uint8_t *in,
-                                   uint8_t *out) {
+static void cryp_exchange(CRYDriver *cryp,
+                          size_t size,
+                          const uint8_t *in,
+                          uint8_t *out) {
   uint32_t szw;
 
   szw = (uint32_t)(size / sizeof (uint32_t));
@@ -198,6 +246,27 @@ static cryerror_t cryp_do_transfer(CRYDriver *cryp,
     }
   }
 #endif
+}
+
+/**
+ * @brief   Performs a CRYP operation using DMA.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                input buffer
+ * @param[out] out              output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ */
+static cryerror_t cryp_do_transfer(CRYDriver *cryp,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out) {
+
+  cryp_exchange(cryp, size, in, out);
 
   /* Disabling unit.*/
   CRYP->CR &= ~CRYP_CR_CRYPEN;
@@ -205,387 +274,1546 @@ static cryerror_t cryp_do_transfer(CRYDriver *cryp,
   return CRY_NOERROR;
 }
 
+#if (CRY_LLD_SUPPORTS_AES_CTR == TRUE) ||                                   \
+    (CRY_LLD_SUPPORTS_AES_STREAM == TRUE) ||                                \
+    defined(__DOXYGEN__)
 /**
- * @brief   CRYP-IN DMA ISR.
+ * @brief   Processes a trailing partial CTR block.
+ * @details A zero block is pushed in order to get the key stream block of
+ *          the current counter, the unused part is left in @p ks.
  *
- * @param[in] cryp              pointer to the @p CRYDriver object
- * @param[in] flags             pre-shifted content of the ISR register
+ * @param[in] size              size of both buffers, less than 16
+ * @param[in] in                input buffer
+ * @param[out] out              output buffer
+ * @param[out] ks               128 bits key stream block
  */
-static void cry_lld_serve_cryp_in_interrupt(CRYDriver *cryp, uint32_t flags) {
+static void cryp_ctr_tail(size_t size, const uint8_t *in, uint8_t *out,
+                          uint32_t *ks) {
+  const uint8_t *p = (const uint8_t *)ks;
+  unsigned i;
 
-  (void)cryp;
+  for (i = 0U; i < 4U; i++) {
+    while ((CRYP->SR & CRYP_SR_IFNF) == 0U) {
+    }
+    CRYP->DIN = 0U;
+  }
+  for (i = 0U; i < 4U; i++) {
+    while ((CRYP->SR & CRYP_SR_OFNE) == 0U) {
+    }
+    ks[i] = CRYP->DOUT;
+  }
 
-  /* DMA errors handling.*/
-#if defined(STM32_CRY_CRYP_DMA_ERROR_HOOK)
-  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0U) {
-    STM32_CRY_CRYP_DMA_ERROR_HOOK(cryp);
+  for (i = 0U; i < size; i++) {
+    out[i] = in[i] ^ p[i];
   }
-#endif
 }
 
 /**
- * @brief   CRYP-OUT DMA ISR.
+ * @brief   Performs a CTR operation of any size.
+ * @note    The unit is left enabled.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
- * @param[in] flags             pre-shifted content of the ISR register
+ * @param[in] size              size of both buffers
+ * @param[in] in                input buffer
+ * @param[out] out              output buffer
+ * @param[out] ks               128 bits key stream block of the trailing
+ *                              partial block
  */
-static void cry_lld_serve_cryp_out_interrupt(CRYDriver *cryp, uint32_t flags) {
-
-  /* DMA errors handling.*/
-#if defined(STM32_CRY_CRYP_DMA_ERROR_HOOK)
-  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0U) {
-    STM32_CRY_CRYP_DMA_ERROR_HOOK(cryp);
+static void cryp_ctr_transfer(CRYDriver *cryp, size_t size,
+                              const uint8_t *in, uint8_t *out,
+                              uint32_t *ks) {
+  size_t tail;
+
+  tail = size % 16U;
+  if (size > tail) {
+    cryp_exchange(cryp, size - tail, in, out);
+  }
+  if (tail > 0U) {
+    cryp_ctr_tail(tail, &in[size - tail], &out[size - tail], ks);
   }
+}
 #endif
 
-  /* End buffer interrupt.*/
-  if ((flags & STM32_DMA_ISR_TCIF) != 0U) {
-
-    /* Clearing flags of the other stream too.*/
-    dmaStreamClearInterrupt(cryp->cryp_dma_in);
+#if (CRY_LLD_SUPPORTS_AES_GCM == TRUE) ||                                   \
+    (CRY_LLD_SUPPORTS_AES_CCM == TRUE) ||                                   \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Pushes a single block into the CRYP input FIFO.
+ *
+ * @param[in] blk               16 bytes block
+ */
+static void cryp_push_block(const uint8_t *blk) {
+  unsigned i;
 
-    /* Resuming waiting thread.*/
-    osalSysLockFromISR();
-    osalThreadResumeI(&cryp->cryp_tr, MSG_OK);
-    osalSysUnlockFromISR();
+  for (i = 0U; i < 16U; i += 4U) {
+    while ((CRYP->SR & CRYP_SR_IFNF) == 0U) {
+    }
+    CRYP->DIN = __UNALIGNED_UINT32_READ(&blk[i]);
   }
 }
-#endif
 
-#if (STM32_CRY_USE_HASH1 == TRUE) || defined (__DOXYGEN__)
-#if (STM32_CRY_HASH_SIZE_THRESHOLD != 0) || defined (__DOXYGEN__)
 /**
- * @brief   HASH DMA ISR.
+ * @brief   Pushes the header data of an authenticated operation.
+ * @details Nothing comes out of the output FIFO during the header phase,
+ *          only the input DMA stream is used. A trailing partial block is
+ *          padded with zeros.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
- * @param[in] flags             pre-shifted content of the ISR register
+ * @param[in] size              size of the header
+ * @param[in] in                header buffer
  */
-static void cry_lld_serve_hash_interrupt(CRYDriver *cryp, uint32_t flags) {
+static void cryp_push_header(CRYDriver *cryp, size_t size, const uint8_t *in) {
+  uint8_t blk[16];
+  size_t tail, szw;
 
-  /* DMA errors handling.*/
-#if defined(STM32_HASH_DMA_ERROR_HOOK)
-  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0U) {
-    STM32_CRY_HASH_DMA_ERROR_HOOK(cryp);
+  (void)cryp; /* Not touched in some cases, needs this.*/
+
+  tail = size % 16U;
+  szw  = (size - tail) / sizeof (uint32_t);
+#if STM32_CRY_CRYP_SIZE_THRESHOLD != 0
+  if ((szw > 0U) && ((size - tail) >= STM32_CRY_CRYP_SIZE_THRESHOLD) &&
+      (((uint32_t)in & 3U) == 0U)) {
+    /* DMA limitation.*/
+    osalDbgCheck(szw < 0x10000U);
+
+    osalSysLock();
+
+    /* Only the input stream is used, its completion ends the wait.*/
+    dmaStreamSetTransactionSize(cryp->cryp_dma_in, szw);
+    dmaStreamSetMemory0(cryp->cryp_dma_in, in);
+    cryp->cryp_dma_in->stream->CR |= STM32_DMA_CR_TCIE;
+    dmaStreamEnable(cryp->cryp_dma_in);
+
+    (void) osalThreadSuspendS(&cryp->cryp_tr);
+
+    cryp->cryp_dma_in->stream->CR &= ~STM32_DMA_CR_TCIE;
+
+    osalSysUnlock();
+
+    in += size - tail;
+    szw = 0U;
   }
 #endif
+  while (szw > 0U) {
+    while ((CRYP->SR & CRYP_SR_IFNF) == 0U) {
+    }
+    CRYP->DIN = __UNALIGNED_UINT32_READ(in);
+    in += 4;
+    szw--;
+  }
 
-  /* End buffer interrupt.*/
-  if ((flags & STM32_DMA_ISR_TCIF) != 0U) {
+  if (tail > 0U) {
+    memset((void *)blk, 0, sizeof blk);
+    memcpy((void *)blk, (const void *)in, tail);
+    cryp_push_block(blk);
+  }
+}
 
-    /* Resuming waiting thread.*/
-    osalSysLockFromISR();
-    osalThreadResumeI(&cryp->hash_tr, MSG_OK);
-    osalSysUnlockFromISR();
+/**
+ * @brief   Switches an authenticated operation to the specified phase.
+ * @note    The final phase requires ALGODIR cleared in both directions.
+ *
+ * @param[in] phase             GCM_CCMPH field of CR register
+ */
+static void cryp_aead_phase(uint32_t phase) {
+  uint32_t cr;
+
+  /* The init and header phases produce no output, the input FIFO must be
+     drained before the phase can be changed.*/
+  cryp_wait_idle();
+  CRYP->CR &= ~CRYP_CR_CRYPEN;
+
+  cr = CRYP->CR & ~CRYP_CR_GCM_CCMPH;
+  if (phase == CRYP_CR_GCM_CCMPH) {
+    cr &= ~CRYP_CR_ALGODIR;
   }
+  CRYP->CR = cr | phase | CRYP_CR_CRYPEN;
 }
-#endif
-#endif
 
 /**
- * @brief   Pushes a series of words into the hash engine.
+ * @brief   Init phase of an authenticated operation.
+ * @details The engine clears CRYPEN by itself at the end of the phase.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
- * @param[in] n                 the number of words to be pushed
- * @param[in] p                 pointer to the words buffer
+ * @param[in] algomode          algorithm mode and direction fields of CR
+ *                              register
+ * @param[in] ctr               128 bits initial counter block
+ * @param[in] b0                128 bits B0 block for CCM or @p NULL
  */
-static void cry_lld_hash_push(CRYDriver *cryp, uint32_t n, const uint32_t *p) {
-
-  (void)cryp; /* Not touched in some cases, needs this.*/
+static void cryp_aead_init(CRYDriver *cryp, uint32_t algomode,
+                           const uint8_t *ctr, const uint8_t *b0) {
+  uint32_t cr;
 
-  /* Data is processed in 32kB blocks because DMA size limitations.*/
-  while (n > 0U) {
-    uint32_t chunk = n > 0x8000U ? 0x8000U : n;
-    n -= chunk;
+  CRYP->CR &= ~CRYP_CR_CRYPEN;
+  if (cryp->cryp_ktype != cryp_key_aes_encrypt) {
+    cryp_load_key(cryp);
+    cryp->cryp_ktype = cryp_key_aes_encrypt;
+  }
+  cryp_set_iv(cryp, ctr);
 
-#if STM32_CRY_HASH_SIZE_THRESHOLD > 1
-    if (chunk >= STM32_CRY_HASH_SIZE_THRESHOLD)
-#endif
-#if STM32_CRY_HASH_SIZE_THRESHOLD != 0
-    {
-      /* Setting up transfer.*/
-      dmaStreamSetTransactionSize(cryp->hash_dma, chunk);
-      dmaStreamSetPeripheral(cryp->hash_dma, p);
-      p += chunk;
+  cr  = CRYP->CR;
+  cr &= ~(CRYP_CR_KEYSIZE_Msk | CRYP_CR_ALGOMODE_Msk | CRYP_CR_ALGODIR_Msk |
+          CRYP_CR_AEAD_MASK);
+  cr |= cryp->cryp_ksize | algomode | CRYP_CR_CRYPEN;
+  CRYP->CR = cr;
 
-      osalSysLock();
+  if (b0 != NULL) {
+    cryp_push_block(b0);
+  }
+  while ((CRYP->CR & CRYP_CR_CRYPEN) != 0U) {
+  }
+}
 
-      /* Enabling DMA channel then HASH engine.*/
-      dmaStreamEnable(cryp->hash_dma);
+/**
+ * @brief   Payload phase of an authenticated operation.
+ * @details Whole blocks go through @p cryp_exchange(), a trailing partial
+ *          block is zero padded and processed by polling.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              size of both buffers
+ * @param[in] in                input buffer
+ * @param[out] out              output buffer
+ * @param[in] npblb             the padding bytes of the last block must
+ *                              be excluded from the tag computation
+ */
+static void cryp_aead_payload(CRYDriver *cryp, size_t size,
+                              const uint8_t *in, uint8_t *out,
+                              bool npblb) {
+  uint32_t blk[4];
+  size_t tail;
+  unsigned i;
 
-      /* Waiting for DMA operation completion.*/
-      osalThreadSuspendS(&cryp->hash_tr);
+  tail = size % 16U;
+  if (size > tail) {
+    cryp_exchange(cryp, size - tail, in, out);
+  }
 
-      osalSysUnlock();
+  if (tail > 0U) {
+#if defined(CRYP_CR_NPBLB)
+    if (npblb) {
+      cryp_wait_idle();
+      CRYP->CR &= ~CRYP_CR_CRYPEN;
+      CRYP->CR |= ((16U - (uint32_t)tail) << CRYP_CR_NPBLB_Pos);
+      CRYP->CR |= CRYP_CR_CRYPEN;
     }
+#else
+    osalDbgAssert(!npblb, "partial block not supported");
 #endif
-#if STM32_CRY_HASH_SIZE_THRESHOLD > 1
-    else
-#endif
-#if STM32_CRY_HASH_SIZE_THRESHOLD != 1
-    {
-      /* Small chunk, just pushing data without touching DMA.*/
-      do {
-        HASH->DIN = *p++;
-        chunk--;
-      } while (chunk > 0U);
+    memset((void *)blk, 0, sizeof blk);
+    memcpy((void *)blk, (const void *)&in[size - tail], tail);
+    cryp_push_block((const uint8_t *)blk);
+    for (i = 0U; i < 4U; i++) {
+      while ((CRYP->SR & CRYP_SR_OFNE) == 0U) {
+      }
+      blk[i] = CRYP->DOUT;
     }
-#endif
+    memcpy((void *)&out[size - tail], (const void *)blk, tail);
   }
-
 }
 
-/*===========================================================================*/
-/* Driver interrupt handlers.                                                */
-/*===========================================================================*/
-
-/*===========================================================================*/
-/* Driver exported functions.                                                */
-/*===========================================================================*/
-
 /**
- * @brief   Low level crypto driver initialization.
+ * @brief   Final phase of an authenticated operation.
+ * @details The unit is disabled on exit.
  *
- * @notapi
+ * @param[in] blk               128 bits final block
+ * @param[out] tag              128 bits computed tag
  */
-void cry_lld_init(void) {
+static void cryp_aead_final(const uint8_t *blk, uint32_t *tag) {
+  unsigned i;
 
-#if STM32_CRY_ENABLED1
-  cryObjectInit(&CRYD1);
+  cryp_aead_phase(CRYP_CR_GCM_CCMPH);
+  cryp_push_block(blk);
+  for (i = 0U; i < 4U; i++) {
+    while ((CRYP->SR & CRYP_SR_OFNE) == 0U) {
+    }
+    tag[i] = CRYP->DOUT;
+  }
 
-#if STM32_CRY_USE_CRYP1
-#if STM32_CRY_CRYP_SIZE_THRESHOLD != 0
-  CRYD1.cryp_tr      = NULL;
-  CRYD1.cryp_dma_in  = NULL;
-  CRYD1.cryp_dma_out = NULL;
-#endif
-#endif
+  CRYP->CR &= ~(CRYP_CR_CRYPEN | CRYP_CR_AEAD_MASK);
+}
 
-#if STM32_CRY_USE_HASH1
-#if STM32_CRY_HASH_SIZE_THRESHOLD != 0
-  CRYD1.hash_tr      = NULL;
-  CRYD1.hash_dma     = NULL;
-#endif /* STM32_CRY_HASH_SIZE_THRESHOLD != 0 */
-#endif /* STM32_CRY_USE_HASH1 */
+/**
+ * @brief   Checks a received tag against the computed one.
+ * @note    The comparison time does not depend on the tag content.
+ *
+ * @param[in] tag               computed tag
+ * @param[in] tag_in            received tag
+ * @param[in] tag_size          size of the tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the tags match.
+ * @retval CRY_ERR_AUTH_FAILED  if the tags differ.
+ */
+static cryerror_t cryp_aead_check(const uint32_t *tag,
+                                  const uint8_t *tag_in,
+                                  size_t tag_size) {
+  const uint8_t *p = (const uint8_t *)tag;
+  uint8_t diff = 0U;
+  size_t i;
+
+  for (i = 0U; i < tag_size; i++) {
+    diff |= p[i] ^ tag_in[i];
+  }
 
-#endif /* STM32_CRY_ENABLED1 */
+  return diff == 0U ? CRY_NOERROR : CRY_ERR_AUTH_FAILED;
 }
+#endif /* CRY_LLD_SUPPORTS_AES_GCM || CRY_LLD_SUPPORTS_AES_CCM */
 
+#if (CRY_LLD_SUPPORTS_AES_GCM == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Configures and activates the crypto peripheral.
+ * @brief   Init phase of an AES-GCM operation.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] algodir           ALGODIR field of CR register
+ * @param[in] iv                128 bits input vector, only the first 96 bits
+ *                              are used
+ */
+static void cryp_gcm_init(CRYDriver *cryp, uint32_t algodir,
+                          const uint8_t *iv) {
+  uint8_t ctr[16];
+
+  /* Counter starts from 2, 1 is reserved to the tag encryption.*/
+  memcpy((void *)ctr, (const void *)iv, 12U);
+  ctr[12] = 0U;
+  ctr[13] = 0U;
+  ctr[14] = 0U;
+  ctr[15] = 2U;
+  cryp_aead_init(cryp, CRYP_CR_ALGOMODE_AES_GCM | algodir, ctr, NULL);
+}
+
+/**
+ * @brief   Final phase of an AES-GCM operation.
  *
- * @notapi
+ * @param[in] auth_size         total size of the authenticated data
+ * @param[in] text_size         total size of the text
+ * @param[out] tag              128 bits computed tag
  */
-void cry_lld_start(CRYDriver *cryp) {
+static void cryp_gcm_final(size_t auth_size, size_t text_size,
+                           uint32_t *tag) {
+  uint32_t len[4];
+
+  /* Lengths in bits as two 64 bits big endian numbers.*/
+  len[0] = __REV((uint32_t)((uint64_t)auth_size >> 29));
+  len[1] = __REV((uint32_t)auth_size << 3);
+  len[2] = __REV((uint32_t)((uint64_t)text_size >> 29));
+  len[3] = __REV((uint32_t)text_size << 3);
+  cryp_aead_final((const uint8_t *)len, tag);
+}
 
-  if (cryp->state == CRY_STOP) {
+/**
+ * @brief   Performs an AES-GCM operation.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] algodir           ALGODIR field of CR register
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input text
+ * @param[out] text_out         buffer for the output text
+ * @param[in] iv                128 bits input vector, only the first 96 bits
+ *                              are used
+ * @param[out] tag              128 bits computed tag
+ */
+static void cryp_gcm(CRYDriver *cryp, uint32_t algodir,
+                     size_t auth_size, const uint8_t *auth_in,
+                     size_t text_size, const uint8_t *text_in,
+                     uint8_t *text_out, const uint8_t *iv,
+                     uint32_t *tag) {
 
-#if STM32_CRY_ENABLED1
-    if (&CRYD1 == cryp) {
-#if STM32_CRY_USE_CRYP1 == TRUE
-#if STM32_CRY_CRYP_SIZE_THRESHOLD != 0
-      /* Allocating DMA channels.*/
-      cryp->cryp_dma_in  = dmaStreamAllocI(STM32_CRY_CRYP1_IN_DMA_STREAM,
-                                           STM32_CRY_CRYP1_IRQ_PRIORITY,
-                                           (stm32_dmaisr_t)cry_lld_serve_cryp_in_interrupt,
-                                           (void *)cryp);
-      osalDbgAssert(cryp->cryp_dma_in != NULL, "unable to allocate stream");
-      cryp->cryp_dma_out = dmaStreamAllocI(STM32_CRY_CRYP1_OUT_DMA_STREAM,
-                                           STM32_CRY_CRYP1_IRQ_PRIORITY,
-                                           (stm32_dmaisr_t)cry_lld_serve_cryp_out_interrupt,
-                                           (void *)cryp);
-      osalDbgAssert(cryp->cryp_dma_out != NULL, "unable to allocate stream");
+  cryp_gcm_init(cryp, algodir, iv);
 
-      /* Preparing the DMA channels.*/
-      dmaStreamSetMode(cryp->cryp_dma_in,
-                       STM32_DMA_CR_CHSEL(CRYP1_IN_DMA_CHANNEL) |
-                       STM32_DMA_CR_PL(STM32_CRY_CRYP1_IN_DMA_PRIORITY) |
-                       STM32_DMA_CR_MINC | STM32_DMA_CR_DIR_M2P |
-                       STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_PSIZE_WORD |
-                       STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE);
-      dmaStreamSetMode(cryp->cryp_dma_out,
-                       STM32_DMA_CR_CHSEL(CRYP1_OUT_DMA_CHANNEL) |
-                       STM32_DMA_CR_PL(STM32_CRY_CRYP1_OUT_DMA_PRIORITY) |
-                       STM32_DMA_CR_MINC | STM32_DMA_CR_DIR_P2M |
-                       STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_PSIZE_WORD |
-                       STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE |
-                       STM32_DMA_CR_TCIE);
-      dmaStreamSetPeripheral(cryp->cryp_dma_in,  &CRYP->DIN);
-      dmaStreamSetPeripheral(cryp->cryp_dma_out, &CRYP->DOUT);
-      dmaStreamSetFIFO(cryp->cryp_dma_in,  STM32_DMA_FCR_DMDIS);
-      dmaStreamSetFIFO(cryp->cryp_dma_out, STM32_DMA_FCR_DMDIS);
-#if STM32_DMA_SUPPORTS_DMAMUX
-      dmaSetRequestSource(cryp->cryp_dma_in, STM32_DMAMUX1_CRYP_IN);
-      dmaSetRequestSource(cryp->cryp_dma_out, STM32_DMAMUX1_CRYP_OUT);
-#endif
-#endif /* STM32_CRY_CRYP_SIZE_THRESHOLD != 0 */
-      rccEnableCRYP(true);
-#endif /* STM32_CRY_USE_CRYP1 == TRUE */
+  if (auth_size > 0U) {
+    cryp_aead_phase(CRYP_CR_GCM_CCMPH_0);
+    cryp_push_header(cryp, auth_size, auth_in);
+  }
 
-#if STM32_CRY_USE_HASH1 == TRUE
-#if STM32_CRY_HASH_SIZE_THRESHOLD != 0
-      cryp->hash_dma = dmaStreamAllocI(STM32_CRY_HASH1_DMA_STREAM,
-                                       STM32_CRY_HASH1_IRQ_PRIORITY,
-                                       (stm32_dmaisr_t)cry_lld_serve_hash_interrupt,
-                                       (void *)cryp);
-      osalDbgAssert(cryp->hash_dma != NULL, "unable to allocate stream");
+  if (text_size > 0U) {
+    cryp_aead_phase(CRYP_CR_GCM_CCMPH_1);
+    cryp_aead_payload(cryp, text_size, text_in, text_out, algodir == 0U);
+  }
 
-      /* Preparing the DMA channel.*/
-      dmaStreamSetMode(cryp->hash_dma,
-                       STM32_DMA_CR_CHSEL(HASH1_DMA_CHANNEL) |
-                       STM32_DMA_CR_PL(STM32_CRY_HASH1_DMA_PRIORITY) |
-                       STM32_DMA_CR_PINC | STM32_DMA_CR_DIR_M2M |
-                       STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_PSIZE_WORD |
-                       STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE |
-                       STM32_DMA_CR_TCIE);
-      dmaStreamSetMemory0(cryp->hash_dma, &HASH->DIN);
-      dmaStreamSetFIFO(cryp->hash_dma, STM32_DMA_FCR_DMDIS);
-#if STM32_DMA_SUPPORTS_DMAMUX
-      dmaSetRequestSource(cryp->hash_dma, STM32_DMAMUX1_HASH_IN);
+  cryp_gcm_final(auth_size, text_size, tag);
+}
 #endif
-#endif /* STM32_CRY_HASH_SIZE_THRESHOLD != 0 */
-      rccEnableHASH(true);
-#endif /* STM32_CRY_USE_HASH1 == TRUE */
+
+#if (CRY_LLD_SUPPORTS_AES_CCM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Performs an AES-CCM operation.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] algodir           ALGODIR field of CR register
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input text
+ * @param[out] text_out         buffer for the output text
+ * @param[in] nonce_size        size of the nonce, from 7 to 13
+ * @param[in] nonce             buffer containing the nonce
+ * @param[in] tag_size          size of the tag, even and from 4 to 16
+ * @param[out] tag              128 bits computed tag
+ */
+static void cryp_ccm(CRYDriver *cryp, uint32_t algodir,
+                     size_t auth_size, const uint8_t *auth_in,
+                     size_t text_size, const uint8_t *text_in,
+                     uint8_t *text_out, size_t nonce_size,
+                     const uint8_t *nonce, size_t tag_size,
+                     uint32_t *tag) {
+  uint8_t b0[16], ctr[16], hdr[16];
+  size_t l, i, n;
+
+  /* B0 block and first counter block, L is the size of the length field.*/
+  l = 15U - nonce_size;
+  b0[0] = (uint8_t)(((auth_size > 0U) ? 0x40U : 0U) |
+                    (((tag_size - 2U) / 2U) << 3) | (l - 1U));
+  memcpy((void *)&b0[1], (const void *)nonce, nonce_size);
+  for (i = 0U; i < l; i++) {
+    b0[15U - i] = i < sizeof (size_t) ? (uint8_t)(text_size >> (8U * i)) : 0U;
+  }
+  memset((void *)ctr, 0, sizeof ctr);
+  ctr[0] = (uint8_t)(l - 1U);
+  memcpy((void *)&ctr[1], (const void *)nonce, nonce_size);
+  ctr[15] = 1U;
+  cryp_aead_init(cryp, CRYP_CR_ALGOMODE_AES_CCM | algodir, ctr, b0);
+
+  if (auth_size > 0U) {
+    cryp_aead_phase(CRYP_CR_GCM_CCMPH_0);
+
+    /* The first block starts with the encoded header length.*/
+    memset((void *)hdr, 0, sizeof hdr);
+    if (auth_size < 0xFF00U) {
+      hdr[0] = (uint8_t)(auth_size >> 8);
+      hdr[1] = (uint8_t)auth_size;
+      n = 2U;
     }
-#endif
+    else {
+      hdr[0] = 0xFFU;
+      hdr[1] = 0xFEU;
+      hdr[2] = (uint8_t)(auth_size >> 24);
+      hdr[3] = (uint8_t)(auth_size >> 16);
+      hdr[4] = (uint8_t)(auth_size >> 8);
+      hdr[5] = (uint8_t)auth_size;
+      n = 6U;
+    }
+    i = auth_size < 16U - n ? auth_size : 16U - n;
+    memcpy((void *)&hdr[n], (const void *)auth_in, i);
+    cryp_push_block(hdr);
+    cryp_push_header(cryp, auth_size - i, auth_in + i);
   }
 
-  /* Resetting trasient key data.*/
-  cryp->cryp_ktype = cryp_key_none;
-  cryp->cryp_ksize = 0U;
-  cryp->cryp_k[0]  = 0U;
-  cryp->cryp_k[1]  = 0U;
-  cryp->cryp_k[2]  = 0U;
-  cryp->cryp_k[3]  = 0U;
-  cryp->cryp_k[4]  = 0U;
-  cryp->cryp_k[5]  = 0U;
-  cryp->cryp_k[6]  = 0U;
-  cryp->cryp_k[7]  = 0U;
-
-#if STM32_CRY_USE_CRYP1
-  /* CRYP setup.*/
-  CRYP->CR    = CRYP_CR_DATATYPE_1;
-  CRYP->DMACR = CRYP_DMACR_DIEN | CRYP_DMACR_DOEN;
-#endif
+  if (text_size > 0U) {
+    cryp_aead_phase(CRYP_CR_GCM_CCMPH_1);
+    cryp_aead_payload(cryp, text_size, text_in, text_out, algodir != 0U);
+  }
 
-#if STM32_CRY_USE_HASH1
-  /* HASH setup and enable.*/
-#endif
+  /* The final block is the counter block zero.*/
+  ctr[15] = 0U;
+  cryp_aead_final(ctr, tag);
 }
+#endif
 
+#if (CRY_LLD_SUPPORTS_AES_STREAM == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Deactivates the crypto peripheral.
+ * @brief   Restores the chaining state of a streaming context.
+ * @details The key registers are only reloaded, and the decryption key only
+ *          prepared, if another operation used them since the last call.
+ *          GCM contexts are left disabled, the caller selects the phase.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] ctxp              pointer to an AES context
+ */
+static void cryp_stream_restore(CRYDriver *cryp, const AESContext *ctxp) {
+  uint32_t algomode = ctxp->cr & CRYP_CR_ALGOMODE_Msk;
+
+  CRYP->CR &= ~CRYP_CR_CRYPEN;
+  CRYP->IV0LR = ctxp->iv[0];
+  CRYP->IV0RR = ctxp->iv[1];
+  CRYP->IV1LR = ctxp->iv[2];
+  CRYP->IV1RR = ctxp->iv[3];
+
+  if (algomode == CRYP_CR_ALGOMODE_AES_GCM) {
+    volatile uint32_t *csp = &CRYP->CSGCMCCM0R;
+    unsigned i;
+
+    if (cryp->cryp_ktype != cryp_key_aes_encrypt) {
+      cryp_load_key(cryp);
+      cryp->cryp_ktype = cryp_key_aes_encrypt;
+    }
+    CRYP->CR = ctxp->cr & ~CRYP_CR_CRYPEN;
+
+    /* CSGCMCCMxR and CSGCMxR registers are contiguous.*/
+    for (i = 0U; i < 16U; i++) {
+      csp[i] = ctxp->csgcm[i];
+    }
+  }
+  else if ((ctxp->cr & CRYP_CR_ALGODIR) != 0U) {
+    cryp_set_key_decrypt(cryp, algomode);
+  }
+  else {
+    cryp_set_key_encrypt(cryp, algomode);
+  }
+}
+
+/**
+ * @brief   Saves the chaining state of a streaming context.
+ * @details The unit is disabled on exit.
  *
- * @notapi
+ * @param[out] ctxp             pointer to an AES context
  */
-void cry_lld_stop(CRYDriver *cryp) {
+static void cryp_stream_save(AESContext *ctxp) {
 
-  if (cryp->state == CRY_READY) {
+  /* Header blocks pushed by cry_lld_AES_GCM_auth() can still be in the
+     input FIFO.*/
+  cryp_wait_idle();
+  CRYP->CR &= ~CRYP_CR_CRYPEN;
 
-    /* Resetting CRYP.*/
-    CRYP->CR    = 0U;
-    CRYP->DMACR = 0U;
+  ctxp->cr    = CRYP->CR;
+  ctxp->iv[0] = CRYP->IV0LR;
+  ctxp->iv[1] = CRYP->IV0RR;
+  ctxp->iv[2] = CRYP->IV1LR;
+  ctxp->iv[3] = CRYP->IV1RR;
 
-#if STM32_CRY_ENABLED1
-    if (&CRYD1 == cryp) {
-#if STM32_CRY_USE_CRYP1
-#if STM32_CRY_CRYP_SIZE_THRESHOLD != 0
-      dmaStreamFreeI(cryp->cryp_dma_in);
-      dmaStreamFreeI(cryp->cryp_dma_out);
-      cryp->cryp_dma_in = NULL;
-      cryp->cryp_dma_out = NULL;
-#endif
-      rccDisableCRYP();
-#endif
+  if ((ctxp->cr & CRYP_CR_ALGOMODE_Msk) == CRYP_CR_ALGOMODE_AES_GCM) {
+    volatile uint32_t *csp = &CRYP->CSGCMCCM0R;
+    unsigned i;
 
-#if STM32_CRY_USE_HASH1
-#if STM32_CRY_HASH_SIZE_THRESHOLD != 0
-      dmaStreamFreeI(cryp->hash_dma);
-      cryp->hash_dma = NULL;
-#endif
-      rccDisableHASH();
-#endif
+    for (i = 0U; i < 16U; i++) {
+      ctxp->csgcm[i] = csp[i];
     }
-#endif
   }
+
+  /* Other operations must not inherit the phase.*/
+  CRYP->CR &= ~CRYP_CR_AEAD_MASK;
 }
 
-#if (CRY_LLD_SUPPORTS_AES == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Initializes the AES transient key.
- * @note    It is the underlying implementation to decide which key sizes are
- *          allowable.
+ * @brief   Common initialization of CBC and CTR streaming contexts.
  *
- * @param[in] cryp              pointer to the @p CRYDriver object
- * @param[in] size              key size in bytes
- * @param[in] keyp              pointer to the key data
- * @return                      The operation status.
- * @retval CRY_NOERROR          if the operation succeeded.
- * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
- * @retval CRY_ERR_INV_KEY_SIZE if the specified key size is invalid for
- *                              the specified algorithm.
+ * @param[out] ctxp             pointer to an AES context
+ * @param[in] cr                algorithm mode and direction fields of CR
+ *                              register
+ * @param[in] iv                128 bits initial vector
+ */
+static void cryp_stream_init(AESContext *ctxp, uint32_t cr,
+                             const uint8_t *iv) {
+
+  memset((void *)ctxp, 0, sizeof (AESContext));
+  ctxp->cr    = cr;
+  ctxp->iv[0] = __REV(__UNALIGNED_UINT32_READ(&iv[0]));
+  ctxp->iv[1] = __REV(__UNALIGNED_UINT32_READ(&iv[4]));
+  ctxp->iv[2] = __REV(__UNALIGNED_UINT32_READ(&iv[8]));
+  ctxp->iv[3] = __REV(__UNALIGNED_UINT32_READ(&iv[12]));
+}
+#endif
+
+#if (STM32_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the AES job at the head of the queue.
+ * @details The key schedule is reused if still in place, the completion
+ *          is signaled by the output DMA stream.
  *
- * @notapi
+ * @param[in] cryp              pointer to the @p CRYDriver object
  */
-cryerror_t cry_lld_aes_loadkey(CRYDriver *cryp,
-                               size_t size,
-                               const uint8_t *keyp) {
+static void cryp_job_start(CRYDriver *cryp) {
+  const cry_aes_job_t *jp = cryp->cryp_job_head;
+  uint32_t szw = (uint32_t)(jp->size / sizeof (uint32_t));
 
-  /* Fetching key data.*/
-  if (size == (size_t)32) {
-    cryp->cryp_ksize = CRYP_CR_KEYSIZE_1;
-    cryp->cryp_k[0] = __REV(__UNALIGNED_UINT32_READ(&keyp[0]));
-    cryp->cryp_k[1] = __REV(__UNALIGNED_UINT32_READ(&keyp[4]));
-    cryp->cryp_k[2] = __REV(__UNALIGNED_UINT32_READ(&keyp[8]));
-    cryp->cryp_k[3] = __REV(__UNALIGNED_UINT32_READ(&keyp[12]));
-    cryp->cryp_k[4] = __REV(__UNALIGNED_UINT32_READ(&keyp[16]));
-    cryp->cryp_k[5] = __REV(__UNALIGNED_UINT32_READ(&keyp[20]));
-    cryp->cryp_k[6] = __REV(__UNALIGNED_UINT32_READ(&keyp[24]));
-    cryp->cryp_k[7] = __REV(__UNALIGNED_UINT32_READ(&keyp[28]));
+  /* The IV is loaded before the unit is enabled.*/
+  if (jp->op >= cry_aes_cbc_encrypt) {
+    cryp_set_iv(cryp, jp->iv);
   }
-  else if (size == (size_t)24) {
-    cryp->cryp_ksize = CRYP_CR_KEYSIZE_0;
-    cryp->cryp_k[0] = 0U;
-    cryp->cryp_k[1] = 0U;
-    cryp->cryp_k[2] = __REV(__UNALIGNED_UINT32_READ(&keyp[8]));
-    cryp->cryp_k[3] = __REV(__UNALIGNED_UINT32_READ(&keyp[12]));
-    cryp->cryp_k[4] = __REV(__UNALIGNED_UINT32_READ(&keyp[16]));
-    cryp->cryp_k[5] = __REV(__UNALIGNED_UINT32_READ(&keyp[20]));
-    cryp->cryp_k[6] = __REV(__UNALIGNED_UINT32_READ(&keyp[24]));
-    cryp->cryp_k[7] = __REV(__UNALIGNED_UINT32_READ(&keyp[28]));
+  switch (jp->op) {
+  case cry_aes_ecb_encrypt:
+    cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_ECB);
+    break;
+  case cry_aes_ecb_decrypt:
+    cryp_set_key_decrypt(cryp, CRYP_CR_ALGOMODE_AES_ECB);
+    break;
+  case cry_aes_cbc_encrypt:
+    cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_CBC);
+    break;
+  case cry_aes_cbc_decrypt:
+    cryp_set_key_decrypt(cryp, CRYP_CR_ALGOMODE_AES_CBC);
+    break;
+  default:
+    cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_CTR);
+    break;
   }
-  else if (size == (size_t)16) {
-    cryp->cryp_ksize = 0U;
-    cryp->cryp_k[0] = 0U;
-    cryp->cryp_k[1] = 0U;
-    cryp->cryp_k[2] = 0U;
-    cryp->cryp_k[3] = 0U;
-    cryp->cryp_k[4] = __REV(__UNALIGNED_UINT32_READ(&keyp[16]));
-    cryp->cryp_k[5] = __REV(__UNALIGNED_UINT32_READ(&keyp[20]));
-    cryp->cryp_k[6] = __REV(__UNALIGNED_UINT32_READ(&keyp[24]));
-    cryp->cryp_k[7] = __REV(__UNALIGNED_UINT32_READ(&keyp[28]));
+
+  dmaStreamSetTransactionSize(cryp->cryp_dma_in,  szw);
+  dmaStreamSetTransactionSize(cryp->cryp_dma_out, szw);
+  dmaStreamSetMemory0(cryp->cryp_dma_in,  jp->in);
+  dmaStreamSetMemory0(cryp->cryp_dma_out, jp->out);
+  dmaStreamEnable(cryp->cryp_dma_in);
+  dmaStreamEnable(cryp->cryp_dma_out);
+}
+
+/**
+ * @brief   AES job end service routine.
+ * @details The next job is started before invoking the callback of the
+ *          completed one in order to keep the unit busy.
+ * @note    The callback is invoked with the system locked.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ */
+static void cryp_job_serve(CRYDriver *cryp) {
+  cry_aes_job_t *jp;
+
+  CRYP->CR &= ~CRYP_CR_CRYPEN;
+
+  osalSysLockFromISR();
+  jp = cryp->cryp_job_head;
+  cryp->cryp_job_head = jp->next;
+  if (cryp->cryp_job_head != NULL) {
+    cryp_job_start(cryp);
   }
   else {
-    return CRY_ERR_INV_KEY_SIZE;
+    cryp->cryp_job_tail = NULL;
+  }
+
+  if (jp->cb != NULL) {
+    jp->cb(cryp, jp);
+  }
+  osalSysUnlockFromISR();
+}
+#endif /* STM32_CRY_USE_QUEUE == TRUE */
+
+/**
+ * @brief   CRYP-IN DMA ISR.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] flags             pre-shifted content of the ISR register
+ */
+static void cry_lld_serve_cryp_in_interrupt(CRYDriver *cryp, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_CRY_CRYP_DMA_ERROR_HOOK)
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0U) {
+    STM32_CRY_CRYP_DMA_ERROR_HOOK(cryp);
+  }
+#endif
+
+  /* End buffer interrupt, only enabled for input-only transfers.*/
+  if ((flags & STM32_DMA_ISR_TCIF) != 0U) {
+
+    /* Resuming waiting thread.*/
+    osalSysLockFromISR();
+    osalThreadResumeI(&cryp->cryp_tr, MSG_OK);
+    osalSysUnlockFromISR();
   }
+}
+
+/**
+ * @brief   CRYP-OUT DMA ISR.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] flags             pre-shifted content of the ISR register
+ */
+static void cry_lld_serve_cryp_out_interrupt(CRYDriver *cryp, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_CRY_CRYP_DMA_ERROR_HOOK)
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0U) {
+    STM32_CRY_CRYP_DMA_ERROR_HOOK(cryp);
+  }
+#endif
+
+  /* End buffer interrupt.*/
+  if ((flags & STM32_DMA_ISR_TCIF) != 0U) {
+
+    /* Clearing flags of the other stream too.*/
+    dmaStreamClearInterrupt(cryp->cryp_dma_in);
+
+#if STM32_CRY_USE_QUEUE == TRUE
+    if (cryp->cryp_job_head != NULL) {
+      cryp_job_serve(cryp);
+      return;
+    }
+#endif
+
+    /* Resuming waiting thread.*/
+    osalSysLockFromISR();
+    osalThreadResumeI(&cryp->cryp_tr, MSG_OK);
+    osalSysUnlockFromISR();
+  }
+}
+#endif
+
+#if (STM32_CRY_USE_HASH1 == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief   Saves the HASH unit state.
+ * @details The context registers are read only after the DMA has finished
+ *          and the unit is waiting for more input words, as required by
+ *          the context swapping procedure.
+ *
+ * @param[out] sp               pointer to the state storage
+ */
+static void hash_save(stm32_hash_state_t *sp) {
+  uint32_t i, n;
+
+  osalDbgAssert(sp->self == (const void *)sp, "owner storage reused");
+
+  /* Waiting for a DMA transfer in progress to end.*/
+  while ((HASH->SR & HASH_SR_DMAS) != 0U) {
+  }
+
+  /* Words pushed by the CPU, either a whole block has been processed or
+     the FIFO is not full and nothing is being processed.*/
+#if defined(HASH_SR_NBWE)
+  while ((HASH->SR & (HASH_SR_DINIS | HASH_SR_NBWE)) == 0U) {
+  }
+#endif
+  while ((HASH->SR & HASH_SR_BUSY) != 0U) {
+  }
+
+  sp->imr = HASH->IMR;
+  sp->str = HASH->STR;
+  sp->cr  = HASH->CR;
+
+  /* The HMAC mode has more internal state.*/
+  n = (sp->cr & HASH_CR_MODE) != 0U ? STM32_HASH_CSR_NUM : HASH_CSR_NUM_HASH;
+  for (i = 0U; i < n; i++) {
+    sp->csr[i] = HASH->CSR[i];
+  }
+  sp->self = NULL;
+}
+
+/**
+ * @brief   Restores the HASH unit state.
+ *
+ * @param[in] sp                pointer to the state storage
+ */
+static void hash_restore(const stm32_hash_state_t *sp) {
+  uint32_t i, n;
+
+  HASH->IMR = sp->imr;
+  HASH->STR = sp->str;
+  HASH->CR  = sp->cr;
+
+  /* The unit is initialized before writing the swap registers.*/
+  HASH->CR  = sp->cr | HASH_CR_INIT;
+  n = (sp->cr & HASH_CR_MODE) != 0U ? STM32_HASH_CSR_NUM : HASH_CSR_NUM_HASH;
+  for (i = 0U; i < n; i++) {
+    HASH->CSR[i] = sp->csr[i];
+  }
+}
+
+/**
+ * @brief   Makes a context the owner of the HASH unit.
+ * @details The state of the previous owner is saved in its own context,
+ *          nothing is done if the context already owns the unit.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sp                state storage of the new owner
+ * @param[in] restore           @p true if the state must be restored, a
+ *                              new context initializes the unit itself
+ */
+static void hash_acquire(CRYDriver *cryp, stm32_hash_state_t *sp,
+                         bool restore) {
+
+  if (cryp->hash_owner != sp) {
+    if (cryp->hash_owner != NULL) {
+      hash_save(cryp->hash_owner);
+    }
+    if (restore) {
+      hash_restore(sp);
+    }
+    sp->self         = (const void *)sp;
+    cryp->hash_owner = sp;
+  }
+}
+
+#if (CRY_LLD_SUPPORTS_SHA256 == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Completes a SHA256 calculation.
+ * @note    The context must own the unit, the unit is released.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha256ctxp        pointer to a SHA256 context
+ * @param[out] out              256 bits output buffer
+ */
+static void hash_sha256_final(CRYDriver *cryp, SHA256Context *sha256ctxp,
+                              uint8_t *out) {
+  uint32_t digest[8];
+
+  if (sha256ctxp->carry_size > 0U) {
+    HASH->DIN = sha256ctxp->carry_data;
+  }
+
+  /* Triggering final calculation and wait for result, NBLW is the number
+     of valid bits in the last word.*/
+  HASH->SR  = 0U;
+  HASH->STR = 8U * sha256ctxp->carry_size;
+  HASH->STR = (8U * sha256ctxp->carry_size) | HASH_STR_DCAL;
+  while ((HASH->SR & HASH_SR_DCIS) == 0U) {
+  }
+
+  /* Reading digest.*/
+  digest[0] = HASH_DIGEST->HR[0];
+  digest[1] = HASH_DIGEST->HR[1];
+  digest[2] = HASH_DIGEST->HR[2];
+  digest[3] = HASH_DIGEST->HR[3];
+  digest[4] = HASH_DIGEST->HR[4];
+  digest[5] = HASH_DIGEST->HR[5];
+  digest[6] = HASH_DIGEST->HR[6];
+  digest[7] = HASH_DIGEST->HR[7];
+  memcpy((void *)out, (const void *)digest, sizeof digest);
+
+  /* The unit is free now.*/
+  sha256ctxp->hash_state.self = NULL;
+  cryp->hash_owner = NULL;
+}
+#endif
+
+#if (STM32_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Pushes the next chunk of the hash job in progress.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @return                      @p true if a DMA transfer has been started,
+ *                              @p false if all the words have been pushed.
+ */
+static bool hash_job_push(CRYDriver *cryp) {
+  uint32_t chunk;
+
+  if (cryp->hash_job_n == 0U) {
+    return false;
+  }
+
+  /* Same 32kB blocks of the synchronous path.*/
+  chunk = cryp->hash_job_n > 0x8000U ? 0x8000U : cryp->hash_job_n;
+  dmaStreamSetTransactionSize(cryp->hash_dma, chunk);
+  dmaStreamSetPeripheral(cryp->hash_dma, cryp->hash_job_p);
+  dmaStreamEnable(cryp->hash_dma);
+  cryp->hash_job_p += chunk;
+  cryp->hash_job_n -= chunk;
+
+  return true;
+}
+
+/**
+ * @brief   Starts the hash job at the head of the queue.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ */
+static void hash_job_start(CRYDriver *cryp) {
+  const cry_hash_job_t *jp = cryp->hash_job_head;
+
+  osalDbgAssert(jp->sha256ctxp->carry_size == 0U, "misaligned context");
+
+  hash_acquire(cryp, &jp->sha256ctxp->hash_state, true);
+  cryp->hash_job_p = (const uint32_t *)(const void *)jp->in;
+  cryp->hash_job_n = (uint32_t)(jp->size / sizeof (uint32_t));
+  (void) hash_job_push(cryp);
+}
+
+/**
+ * @brief   Hash job end service routine.
+ * @details Trailing bytes are kept in the context, the digest is calculated
+ *          here if requested. The next job is started before invoking the
+ *          callback of the completed one.
+ * @note    The callback is invoked with the system locked.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ */
+static void hash_job_serve(CRYDriver *cryp) {
+  cry_hash_job_t *jp = cryp->hash_job_head;
+  SHA256Context *ctxp = jp->sha256ctxp;
+  size_t i;
+
+  if (hash_job_push(cryp)) {
+    return;
+  }
+
+  for (i = jp->size & ~(size_t)3U; i < jp->size; i++) {
+    ((uint8_t *)&ctxp->carry_data)[ctxp->carry_size++] = jp->in[i];
+  }
+  if (jp->out != NULL) {
+    hash_sha256_final(cryp, ctxp, jp->out);
+  }
+
+  osalSysLockFromISR();
+  cryp->hash_job_head = jp->next;
+  if (cryp->hash_job_head != NULL) {
+    hash_job_start(cryp);
+  }
+  else {
+    cryp->hash_job_tail = NULL;
+  }
+
+  if (jp->cb != NULL) {
+    jp->cb(cryp, jp);
+  }
+  osalSysUnlockFromISR();
+}
+#endif /* STM32_CRY_USE_QUEUE == TRUE */
+
+#if (STM32_CRY_HASH_SIZE_THRESHOLD != 0) || defined (__DOXYGEN__)
+/**
+ * @brief   HASH DMA ISR.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] flags             pre-shifted content of the ISR register
+ */
+static void cry_lld_serve_hash_interrupt(CRYDriver *cryp, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_HASH_DMA_ERROR_HOOK)
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0U) {
+    STM32_CRY_HASH_DMA_ERROR_HOOK(cryp);
+  }
+#endif
+
+  /* End buffer interrupt.*/
+  if ((flags & STM32_DMA_ISR_TCIF) != 0U) {
+
+#if STM32_CRY_USE_QUEUE == TRUE
+    if (cryp->hash_job_head != NULL) {
+      hash_job_serve(cryp);
+      return;
+    }
+#endif
+
+    /* Resuming waiting thread.*/
+    osalSysLockFromISR();
+    osalThreadResumeI(&cryp->hash_tr, MSG_OK);
+    osalSysUnlockFromISR();
+  }
+}
+#endif
+#endif
+
+/**
+ * @brief   Pushes a series of words into the hash engine.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] n                 the number of words to be pushed
+ * @param[in] p                 pointer to the words buffer
+ */
+static void cry_lld_hash_push(CRYDriver *cryp, uint32_t n, const uint32_t *p) {
+
+  (void)cryp; /* Not touched in some cases, needs this.*/
+
+  /* Data is processed in 32kB blocks because DMA size limitations.*/
+  while (n > 0U) {
+    uint32_t chunk = n > 0x8000U ? 0x8000U : n;
+    n -= chunk;
+
+#if STM32_CRY_HASH_SIZE_THRESHOLD > 1
+    if (chunk >= STM32_CRY_HASH_SIZE_THRESHOLD)
+#endif
+#if STM32_CRY_HASH_SIZE_THRESHOLD != 0
+    {
+      /* Setting up transfer.*/
+      dmaStreamSetTransactionSize(cryp->hash_dma, chunk);
+      dmaStreamSetPeripheral(cryp->hash_dma, p);
+      p += chunk;
+
+      osalSysLock();
+
+      /* Enabling DMA channel then HASH engine.*/
+      dmaStreamEnable(cryp->hash_dma);
+
+      /* Waiting for DMA operation completion.*/
+      osalThreadSuspendS(&cryp->hash_tr);
+
+      osalSysUnlock();
+    }
+#endif
+#if STM32_CRY_HASH_SIZE_THRESHOLD > 1
+    else
+#endif
+#if STM32_CRY_HASH_SIZE_THRESHOLD != 1
+    {
+      /* Small chunk, just pushing data without touching DMA.*/
+      do {
+        HASH->DIN = *p++;
+        chunk--;
+      } while (chunk > 0U);
+    }
+#endif
+  }
+
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level crypto driver initialization.
+ *
+ * @notapi
+ */
+void cry_lld_init(void) {
+
+#if STM32_CRY_ENABLED1
+  cryObjectInit(&CRYD1);
+
+#if STM32_CRY_USE_CRYP1
+#if STM32_CRY_CRYP_SIZE_THRESHOLD != 0
+  CRYD1.cryp_tr      = NULL;
+  CRYD1.cryp_dma_in  = NULL;
+  CRYD1.cryp_dma_out = NULL;
+#if STM32_CRY_USE_QUEUE == TRUE
+  CRYD1.cryp_job_head = NULL;
+  CRYD1.cryp_job_tail = NULL;
+#endif
+#endif
+#endif
+
+#if STM32_CRY_USE_HASH1
+  CRYD1.hash_owner   = NULL;
+#if STM32_CRY_HASH_SIZE_THRESHOLD != 0
+  CRYD1.hash_tr      = NULL;
+  CRYD1.hash_dma     = NULL;
+#if STM32_CRY_USE_QUEUE == TRUE
+  CRYD1.hash_job_head = NULL;
+  CRYD1.hash_job_tail = NULL;
+#endif
+#endif /* STM32_CRY_HASH_SIZE_THRESHOLD != 0 */
+#endif /* STM32_CRY_USE_HASH1 */
+
+#endif /* STM32_CRY_ENABLED1 */
+}
+
+/**
+ * @brief   Configures and activates the crypto peripheral.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ *
+ * @notapi
+ */
+void cry_lld_start(CRYDriver *cryp) {
+
+  if (cryp->state == CRY_STOP) {
+
+#if STM32_CRY_ENABLED1
+    if (&CRYD1 == cryp) {
+#if STM32_CRY_USE_CRYP1 == TRUE
+#if STM32_CRY_CRYP_SIZE_THRESHOLD != 0
+      /* Allocating DMA channels.*/
+      cryp->cryp_dma_in  = dmaStreamAllocI(STM32_CRY_CRYP1_IN_DMA_STREAM,
+                                           STM32_CRY_CRYP1_IRQ_PRIORITY,
+                                           (stm32_dmaisr_t)cry_lld_serve_cryp_in_interrupt,
+                                           (void *)cryp);
+      osalDbgAssert(cryp->cryp_dma_in != NULL, "unable to allocate stream");
+      cryp->cryp_dma_out = dmaStreamAllocI(STM32_CRY_CRYP1_OUT_DMA_STREAM,
+                                           STM32_CRY_CRYP1_IRQ_PRIORITY,
+                                           (stm32_dmaisr_t)cry_lld_serve_cryp_out_interrupt,
+                                           (void *)cryp);
+      osalDbgAssert(cryp->cryp_dma_out != NULL, "unable to allocate stream");
+
+      /* Preparing the DMA channels.*/
+      dmaStreamSetMode(cryp->cryp_dma_in,
+                       STM32_DMA_CR_CHSEL(CRYP1_IN_DMA_CHANNEL) |
+                       STM32_DMA_CR_PL(STM32_CRY_CRYP1_IN_DMA_PRIORITY) |
+                       STM32_DMA_CR_MINC | STM32_DMA_CR_DIR_M2P |
+                       STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_PSIZE_WORD |
+                       STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE);
+      dmaStreamSetMode(cryp->cryp_dma_out,
+                       STM32_DMA_CR_CHSEL(CRYP1_OUT_DMA_CHANNEL) |
+                       STM32_DMA_CR_PL(STM32_CRY_CRYP1_OUT_DMA_PRIORITY) |
+                       STM32_DMA_CR_MINC | STM32_DMA_CR_DIR_P2M |
+                       STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_PSIZE_WORD |
+                       STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE |
+                       STM32_DMA_CR_TCIE);
+      dmaStreamSetPeripheral(cryp->cryp_dma_in,  &CRYP->DIN);
+      dmaStreamSetPeripheral(cryp->cryp_dma_out, &CRYP->DOUT);
+      dmaStreamSetFIFO(cryp->cryp_dma_in,  STM32_DMA_FCR_DMDIS);
+      dmaStreamSetFIFO(cryp->cryp_dma_out, STM32_DMA_FCR_DMDIS);
+#if STM32_DMA_SUPPORTS_DMAMUX
+      dmaSetRequestSource(cryp->cryp_dma_in, STM32_DMAMUX1_CRYP_IN);
+      dmaSetRequestSource(cryp->cryp_dma_out, STM32_DMAMUX1_CRYP_OUT);
+#endif
+#endif /* STM32_CRY_CRYP_SIZE_THRESHOLD != 0 */
+      rccEnableCRYP(true);
+#endif /* STM32_CRY_USE_CRYP1 == TRUE */
+
+#if STM32_CRY_USE_HASH1 == TRUE
+#if STM32_CRY_HASH_SIZE_THRESHOLD != 0
+      cryp->hash_dma = dmaStreamAllocI(STM32_CRY_HASH1_DMA_STREAM,
+                                       STM32_CRY_HASH1_IRQ_PRIORITY,
+                                       (stm32_dmaisr_t)cry_lld_serve_hash_interrupt,
+                                       (void *)cryp);
+      osalDbgAssert(cryp->hash_dma != NULL, "unable to allocate stream");
+
+      /* Preparing the DMA channel.*/
+      dmaStreamSetMode(cryp->hash_dma,
+                       STM32_DMA_CR_CHSEL(HASH1_DMA_CHANNEL) |
+                       STM32_DMA_CR_PL(STM32_CRY_HASH1_DMA_PRIORITY) |
+                       STM32_DMA_CR_PINC | STM32_DMA_CR_DIR_M2M |
+                       STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_PSIZE_WORD |
+                       STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE |
+                       STM32_DMA_CR_TCIE);
+      dmaStreamSetMemory0(cryp->hash_dma, &HASH->DIN);
+      dmaStreamSetFIFO(cryp->hash_dma, STM32_DMA_FCR_DMDIS);
+#if STM32_DMA_SUPPORTS_DMAMUX
+      dmaSetRequestSource(cryp->hash_dma, STM32_DMAMUX1_HASH_IN);
+#endif
+#endif /* STM32_CRY_HASH_SIZE_THRESHOLD != 0 */
+      rccEnableHASH(true);
+#endif /* STM32_CRY_USE_HASH1 == TRUE */
+    }
+#endif
+  }
+
+  /* Resetting trasient key data.*/
+  cryp->cryp_ktype = cryp_key_none;
+  cryp->cryp_ksize = 0U;
+  cryp->cryp_k[0]  = 0U;
+  cryp->cryp_k[1]  = 0U;
+  cryp->cryp_k[2]  = 0U;
+  cryp->cryp_k[3]  = 0U;
+  cryp->cryp_k[4]  = 0U;
+  cryp->cryp_k[5]  = 0U;
+  cryp->cryp_k[6]  = 0U;
+  cryp->cryp_k[7]  = 0U;
+
+#if STM32_CRY_USE_CRYP1
+  /* CRYP setup.*/
+  CRYP->CR    = CRYP_CR_DATATYPE_1;
+  CRYP->DMACR = CRYP_DMACR_DIEN | CRYP_DMACR_DOEN;
+#endif
+
+#if STM32_CRY_USE_HASH1
+  /* HASH setup and enable.*/
+#endif
+}
+
+/**
+ * @brief   Deactivates the crypto peripheral.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ *
+ * @notapi
+ */
+void cry_lld_stop(CRYDriver *cryp) {
+
+  if (cryp->state == CRY_READY) {
+
+    /* Resetting CRYP.*/
+    CRYP->CR    = 0U;
+    CRYP->DMACR = 0U;
+
+#if STM32_CRY_ENABLED1
+    if (&CRYD1 == cryp) {
+#if STM32_CRY_USE_CRYP1
+#if STM32_CRY_CRYP_SIZE_THRESHOLD != 0
+      dmaStreamFreeI(cryp->cryp_dma_in);
+      dmaStreamFreeI(cryp->cryp_dma_out);
+      cryp->cryp_dma_in = NULL;
+      cryp->cryp_dma_out = NULL;
+#endif
+      rccDisableCRYP();
+#endif
+
+#if STM32_CRY_USE_HASH1
+      /* Contexts in progress survive a stop.*/
+      if (cryp->hash_owner != NULL) {
+        hash_save(cryp->hash_owner);
+        cryp->hash_owner = NULL;
+      }
+#if STM32_CRY_HASH_SIZE_THRESHOLD != 0
+      dmaStreamFreeI(cryp->hash_dma);
+      cryp->hash_dma = NULL;
+#endif
+      rccDisableHASH();
+#endif
+    }
+#endif
+  }
+}
+
+#if (CRY_LLD_SUPPORTS_AES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes the AES transient key.
+ * @note    It is the underlying implementation to decide which key sizes are
+ *          allowable.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
+ * @retval CRY_ERR_INV_KEY_SIZE if the specified key size is invalid for
+ *                              the specified algorithm.
+ *
+ * @notapi
+ */
+cryerror_t cry_lld_aes_loadkey(CRYDriver *cryp,
+                               size_t size,
+                               const uint8_t *keyp) {
+
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  /* Fetching key data.*/
+  if (size == (size_t)32) {
+    cryp->cryp_ksize = CRYP_CR_KEYSIZE_1;
+    cryp->cryp_k[0] = __REV(__UNALIGNED_UINT32_READ(&keyp[0]));
+    cryp->cryp_k[1] = __REV(__UNALIGNED_UINT32_READ(&keyp[4]));
+    cryp->cryp_k[2] = __REV(__UNALIGNED_UINT32_READ(&keyp[8]));
+    cryp->cryp_k[3] = __REV(__UNALIGNED_UINT32_READ(&keyp[12]));
+    cryp->cryp_k[4] = __REV(__UNALIGNED_UINT32_READ(&keyp[16]));
+    cryp->cryp_k[5] = __REV(__UNALIGNED_UINT32_READ(&keyp[20]));
+    cryp->cryp_k[6] = __REV(__UNALIGNED_UINT32_READ(&keyp[24]));
+    cryp->cryp_k[7] = __REV(__UNALIGNED_UINT32_READ(&keyp[28]));
+  }
+  else if (size == (size_t)24) {
+    cryp->cryp_ksize = CRYP_CR_KEYSIZE_0;
+    cryp->cryp_k[0] = 0U;
+    cryp->cryp_k[1] = 0U;
+    cryp->cryp_k[2] = __REV(__UNALIGNED_UINT32_READ(&keyp[0]));
+    cryp->cryp_k[3] = __REV(__UNALIGNED_UINT32_READ(&keyp[4]));
+    cryp->cryp_k[4] = __REV(__UNALIGNED_UINT32_READ(&keyp[8]));
+    cryp->cryp_k[5] = __REV(__UNALIGNED_UINT32_READ(&keyp[12]));
+    cryp->cryp_k[6] = __REV(__UNALIGNED_UINT32_READ(&keyp[16]));
+    cryp->cryp_k[7] = __REV(__UNALIGNED_UINT32_READ(&keyp[20]));
+  }
+  else if (size == (size_t)16) {
+    cryp->cryp_ksize = 0U;
+    cryp->cryp_k[0] = 0U;
+    cryp->cryp_k[1] = 0U;
+    cryp->cryp_k[2] = 0U;
+    cryp->cryp_k[3] = 0U;
+    cryp->cryp_k[4] = __REV(__UNALIGNED_UINT32_READ(&keyp[0]));
+    cryp->cryp_k[5] = __REV(__UNALIGNED_UINT32_READ(&keyp[4]));
+    cryp->cryp_k[6] = __REV(__UNALIGNED_UINT32_READ(&keyp[8]));
+    cryp->cryp_k[7] = __REV(__UNALIGNED_UINT32_READ(&keyp[12]));
+  }
+  else {
+    return CRY_ERR_INV_KEY_SIZE;
+  }
+
+  /* The key registers content is stale now.*/
+  cryp->cryp_ktype = cryp_key_none;
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Encryption of a single block using AES.
+ * @note    The implementation of this function must guarantee that it can
+ *          be called from any context.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @notapi
+ */
+cryerror_t cry_lld_encrypt_AES(CRYDriver *cryp,
+                               crykey_t key_id,
+                               const uint8_t *in,
+                               uint8_t *out) {
+  unsigned i;
+
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  /* Only key zero is supported.*/
+  if (key_id != 0U) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  /* Setting the stored key.*/
+  cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_ECB);
+
+  /* Pushing the AES block in the FIFO, it is assumed to be empty.*/
+  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[0]);
+  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[4]);
+  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[8]);
+  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[12]);
+
+  /* Reading the result.*/
+  for (i = 0U; i < 4; i++, out += 4) {
+    while ((CRYP->SR & CRYP_SR_OFNE) == 0U) {
+    }
+    __UNALIGNED_UINT32_WRITE(out, CRYP->DOUT);
+  }
+
+  /* Disabling unit.*/
+  CRYP->CR &= ~CRYP_CR_CRYPEN;
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Decryption of a single block using AES.
+ * @note    The implementation of this function must guarantee that it can
+ *          be called from any context.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @notapi
+ */
+cryerror_t cry_lld_decrypt_AES(CRYDriver *cryp,
+                               crykey_t key_id,
+                               const uint8_t *in,
+                               uint8_t *out) {
+  unsigned i;
+
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  /* Only key zero is supported.*/
+  if (key_id != 0U) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  /* Setting the stored key.*/
+  cryp_set_key_decrypt(cryp, CRYP_CR_ALGOMODE_AES_ECB);
+
+  /* Pushing the AES block in the FIFO, it is assumed to be empty.*/
+  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[0]);
+  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[4]);
+  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[8]);
+  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[12]);
+
+  /* Reading the result.*/
+  for (i = 0U; i < 4; i++, out += 4) {
+    while ((CRYP->SR & CRYP_SR_OFNE) == 0U) {
+    }
+    __UNALIGNED_UINT32_WRITE(out, CRYP->DOUT);
+  }
+
+  /* Disabling unit.*/
+  CRYP->CR &= ~CRYP_CR_CRYPEN;
+
+  return CRY_NOERROR;
+}
+#endif
+
+#if (CRY_LLD_SUPPORTS_AES_ECB == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Encryption operation using AES-ECB.
+ * @note    The function operates on data buffers whose length is a multiple
+ *          of an AES block, this means that padding must be done by the
+ *          caller.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @notapi
+ */
+cryerror_t cry_lld_encrypt_AES_ECB(CRYDriver *cryp,
+                                   crykey_t key_id,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out) {
+
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  /* Only key zero is supported.*/
+  if (key_id != 0U) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  /* Setting the stored key.*/
+  cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_ECB);
+
+  return cryp_do_transfer(cryp, size, in, out);
+}
+
+/**
+ * @brief   Decryption operation using AES-ECB.
+ * @note    The function operates on data buffers whose length is a multiple
+ *          of an AES block, this means that padding must be done by the
+ *          caller.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @notapi
+ */
+cryerror_t cry_lld_decrypt_AES_ECB(CRYDriver *cryp,
+                                   crykey_t key_id,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out) {
+
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  /* Only key zero is supported.*/
+  if (key_id != 0U) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  /* Setting the stored key.*/
+  cryp_set_key_decrypt(cryp, CRYP_CR_ALGOMODE_AES_ECB);
+
+  return cryp_do_transfer(cryp, size, in, out);
+}
+#endif
+
+#if (CRY_LLD_SUPPORTS_AES_CBC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Encryption operation using AES-CBC.
+ * @note    The function operates on data buffers whose length is a multiple
+ *          of an AES block, this means that padding must be done by the
+ *          caller.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits initial vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @notapi
+ */
+cryerror_t cry_lld_encrypt_AES_CBC(CRYDriver *cryp,
+                                   crykey_t key_id,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out,
+                                   const uint8_t *iv) {
+
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  /* Only key zero is supported.*/
+  if (key_id != 0U) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  /* Setting the stored key and IV.*/
+  cryp_set_iv(cryp, iv);
+  cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_CBC);
+
+  return cryp_do_transfer(cryp, size, in, out);
+}
+
+/**
+ * @brief   Decryption operation using AES-CBC.
+ * @note    The function operates on data buffers whose length is a multiple
+ *          of an AES block, this means that padding must be done by the
+ *          caller.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits initial vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @notapi
+ */
+cryerror_t cry_lld_decrypt_AES_CBC(CRYDriver *cryp,
+                                   crykey_t key_id,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out,
+                                   const uint8_t *iv) {
+
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  /* Only key zero is supported.*/
+  if (key_id != 0U) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  /* Setting the stored key and IV.*/
+  cryp_set_iv(cryp, iv);
+  cryp_set_key_decrypt(cryp, CRYP_CR_ALGOMODE_AES_CBC);
 
-  return CRY_NOERROR;
+  return cryp_do_transfer(cryp, size, in, out);
 }
+#endif
 
+#if (CRY_LLD_SUPPORTS_AES_CFB == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Encryption of a single block using AES.
- * @note    The implementation of this function must guarantee that it can
- *          be called from any context.
+ * @brief   Encryption operation using AES-CFB.
+ * @note    This is a stream cipher, there are no size restrictions.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[in] key_id            the key to be used for the operation, zero is
  *                              the transient key, other values are keys stored
  *                              in an unspecified way
+ * @param[in] size              size of both buffers
  * @param[in] in                buffer containing the input plaintext
  * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits initial vector
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
  * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
@@ -598,52 +1826,35 @@ cryerror_t cry_lld_aes_loadkey(CRYDriver *cryp,
  *
  * @notapi
  */
-cryerror_t cry_lld_encrypt_AES(CRYDriver *cryp,
-                               crykey_t key_id,
-                               const uint8_t *in,
-                               uint8_t *out) {
-  unsigned i;
-
-  /* Only key zero is supported.*/
-  if (key_id != 0U) {
-    return CRY_ERR_INV_KEY_ID;
-  }
-
-  /* Setting the stored key.*/
-  if (cryp->cryp_ktype != cryp_key_aes_encrypt) {
-    cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_ECB);
-  }
-
-  /* Pushing the AES block in the FIFO, it is assumed to be empty.*/
-  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[0]);
-  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[4]);
-  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[8]);
-  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[12]);
-
-  /* Reading the result.*/
-  for (i = 0U; i < 4; i++, out += 4) {
-    while ((CRYP->SR & CRYP_SR_OFNE) == 0U) {
-    }
-    __UNALIGNED_UINT32_WRITE(out, CRYP->DOUT);
-  }
+cryerror_t cry_lld_encrypt_AES_CFB(CRYDriver *cryp,
+                                   crykey_t key_id,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out,
+                                   const uint8_t *iv) {
 
-  /* Disabling unit.*/
-  CRYP->CR &= ~CRYP_CR_CRYPEN;
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+  (void)iv;
 
-  return CRY_NOERROR;
+  return CRY_ERR_INV_ALGO;
 }
 
 /**
- * @brief   Decryption of a single block using AES.
- * @note    The implementation of this function must guarantee that it can
- *          be called from any context.
+ * @brief   Decryption operation using AES-CFB.
+ * @note    This is a stream cipher, there are no size restrictions.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[in] key_id            the key to be used for the operation, zero is
  *                              the transient key, other values are keys stored
  *                              in an unspecified way
- * @param[in] in                buffer containing the input ciphertext
- * @param[out] out              buffer for the output plaintext
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits initial vector
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
  * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
@@ -656,57 +1867,38 @@ cryerror_t cry_lld_encrypt_AES(CRYDriver *cryp,
  *
  * @notapi
  */
-cryerror_t cry_lld_decrypt_AES(CRYDriver *cryp,
-                               crykey_t key_id,
-                               const uint8_t *in,
-                               uint8_t *out) {
-  unsigned i;
-
-  /* Only key zero is supported.*/
-  if (key_id != 0U) {
-    return CRY_ERR_INV_KEY_ID;
-  }
-
-  /* Setting the stored key.*/
-  if (cryp->cryp_ktype != cryp_key_aes_decrypt) {
-    cryp_set_key_decrypt(cryp, CRYP_CR_ALGOMODE_AES_ECB);
-  }
-
-  /* Pushing the AES block in the FIFO, it is assumed to be empty.*/
-  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[0]);
-  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[4]);
-  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[8]);
-  CRYP->DIN = __UNALIGNED_UINT32_READ(&in[12]);
-
-  /* Reading the result.*/
-  for (i = 0U; i < 4; i++, out += 4) {
-    while ((CRYP->SR & CRYP_SR_OFNE) == 0U) {
-    }
-    __UNALIGNED_UINT32_WRITE(out, CRYP->DOUT);
-  }
+cryerror_t cry_lld_decrypt_AES_CFB(CRYDriver *cryp,
+                                   crykey_t key_id,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out,
+                                   const uint8_t *iv) {
 
-  /* Disabling unit.*/
-  CRYP->CR &= ~CRYP_CR_CRYPEN;
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+  (void)iv;
 
-  return CRY_NOERROR;
+  return CRY_ERR_INV_ALGO;
 }
 #endif
 
-#if (CRY_LLD_SUPPORTS_AES_ECB == TRUE) || defined(__DOXYGEN__)
+#if (CRY_LLD_SUPPORTS_AES_CTR == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Encryption operation using AES-ECB.
- * @note    The function operates on data buffers whose length is a multiple
- *          of an AES block, this means that padding must be done by the
- *          caller.
+ * @brief   Encryption operation using AES-CTR.
+ * @note    This is a stream cipher, there are no size restrictions.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[in] key_id            the key to be used for the operation, zero is
  *                              the transient key, other values are keys stored
  *                              in an unspecified way
- * @param[in] size              size of both buffers, this number must be a
- *                              multiple of 16
+ * @param[in] size              size of both buffers
  * @param[in] in                buffer containing the input plaintext
  * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits initial vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
  * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
@@ -719,39 +1911,46 @@ cryerror_t cry_lld_decrypt_AES(CRYDriver *cryp,
  *
  * @notapi
  */
-cryerror_t cry_lld_encrypt_AES_ECB(CRYDriver *cryp,
+cryerror_t cry_lld_encrypt_AES_CTR(CRYDriver *cryp,
                                    crykey_t key_id,
                                    size_t size,
                                    const uint8_t *in,
-                                   uint8_t *out) {
+                                   uint8_t *out,
+                                   const uint8_t *iv) {
+  uint32_t ks[4];
+
+  CRYP_ASSERT_NO_JOBS(cryp);
 
   /* Only key zero is supported.*/
   if (key_id != 0U) {
     return CRY_ERR_INV_KEY_ID;
   }
 
-  /* Setting the stored key.*/
-  if (cryp->cryp_ktype != cryp_key_aes_encrypt) {
-    cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_ECB);
-  }
+  /* Setting the stored key and IV.*/
+  cryp_set_iv(cryp, iv);
+  cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_CTR);
 
-  return cryp_do_transfer(cryp, size, in, out);
+  cryp_ctr_transfer(cryp, size, in, out, ks);
+
+  /* Disabling unit.*/
+  CRYP->CR &= ~CRYP_CR_CRYPEN;
+
+  return CRY_NOERROR;
 }
 
 /**
- * @brief   Decryption operation using AES-ECB.
- * @note    The function operates on data buffers whose length is a multiple
- *          of an AES block, this means that padding must be done by the
- *          caller.
+ * @brief   Decryption operation using AES-CTR.
+ * @note    This is a stream cipher, there are no size restrictions.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[in] key_id            the key to be used for the operation, zero is
  *                              the transient key, other values are keys stored
  *                              in an unspecified way
- * @param[in] size              size of both buffers, this number must be a
- *                              multiple of 16
- * @param[in] in                buffer containing the input plaintext
- * @param[out] out              buffer for the output ciphertext
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits initial vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
  * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
@@ -764,42 +1963,38 @@ cryerror_t cry_lld_encrypt_AES_ECB(CRYDriver *cryp,
  *
  * @notapi
  */
-cryerror_t cry_lld_decrypt_AES_ECB(CRYDriver *cryp,
+cryerror_t cry_lld_decrypt_AES_CTR(CRYDriver *cryp,
                                    crykey_t key_id,
                                    size_t size,
                                    const uint8_t *in,
-                                   uint8_t *out) {
-
-  /* Only key zero is supported.*/
-  if (key_id != 0U) {
-    return CRY_ERR_INV_KEY_ID;
-  }
-
-  /* Setting the stored key.*/
-  if (cryp->cryp_ktype != cryp_key_aes_decrypt) {
-    cryp_set_key_decrypt(cryp, CRYP_CR_ALGOMODE_AES_ECB);
-  }
+                                   uint8_t *out,
+                                   const uint8_t *iv) {
 
-  return cryp_do_transfer(cryp, size, in, out);
+  /* CTR is symmetric, the encryption key is used in both directions.*/
+  return cry_lld_encrypt_AES_CTR(cryp, key_id, size, in, out, iv);
 }
 #endif
 
-#if (CRY_LLD_SUPPORTS_AES_CBC == TRUE) || defined(__DOXYGEN__)
+#if (CRY_LLD_SUPPORTS_AES_GCM == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Encryption operation using AES-CBC.
- * @note    The function operates on data buffers whose length is a multiple
- *          of an AES block, this means that padding must be done by the
- *          caller.
+ * @brief   Encryption operation using AES-GCM.
+ * @note    This is a stream cipher, there are no size restrictions.
+ * @note    Only the first 96 bits of @p iv are used, the counter part is
+ *          initialized by the driver.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[in] key_id            the key to be used for the operation, zero is
  *                              the transient key, other values are keys stored
  *                              in an unspecified way
- * @param[in] size              size of both buffers, this number must be a
- *                              multiple of 16
- * @param[in] in                buffer containing the input plaintext
- * @param[out] out              buffer for the output ciphertext
- * @param[in] iv                128 bits initial vector
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input plaintext
+ * @param[out] text_out         buffer for the output ciphertext
+ * @param[in] iv                128 bits input vector
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[out] tag_out          buffer for the generated authentication tag
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
  * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
@@ -812,42 +2007,61 @@ cryerror_t cry_lld_decrypt_AES_ECB(CRYDriver *cryp,
  *
  * @notapi
  */
-cryerror_t cry_lld_encrypt_AES_CBC(CRYDriver *cryp,
+cryerror_t cry_lld_encrypt_AES_GCM(CRYDriver *cryp,
                                    crykey_t key_id,
-                                   size_t size,
-                                   const uint8_t *in,
-                                   uint8_t *out,
-                                   const uint8_t *iv) {
+                                   size_t auth_size,
+                                   const uint8_t *auth_in,
+                                   size_t text_size,
+                                   const uint8_t *text_in,
+                                   uint8_t *text_out,
+                                   const uint8_t *iv,
+                                   size_t tag_size,
+                                   uint8_t *tag_out) {
+
+  uint32_t tag[4];
+
+  osalDbgCheck((tag_size >= 1U) && (tag_size <= 16U));
+
+  CRYP_ASSERT_NO_JOBS(cryp);
 
   /* Only key zero is supported.*/
   if (key_id != 0U) {
     return CRY_ERR_INV_KEY_ID;
   }
 
-  /* Setting the stored key and IV.*/
-  cryp_set_iv(cryp, iv);
-  if (cryp->cryp_ktype != cryp_key_aes_encrypt) {
-    cryp_set_key_encrypt(cryp, CRYP_CR_ALGOMODE_AES_CBC);
+#if !defined(CRYP_CR_NPBLB)
+  /* Without NPBLB a partial last block would corrupt the tag.*/
+  if ((text_size % 16U) != 0U) {
+    return CRY_ERR_OP_FAILURE;
   }
+#endif
 
-  return cryp_do_transfer(cryp, size, in, out);
+  cryp_gcm(cryp, 0U, auth_size, auth_in, text_size, text_in, text_out,
+           iv, tag);
+  memcpy((void *)tag_out, (const void *)tag, tag_size);
+
+  return CRY_NOERROR;
 }
 
 /**
- * @brief   Decryption operation using AES-CBC.
- * @note    The function operates on data buffers whose length is a multiple
- *          of an AES block, this means that padding must be done by the
- *          caller.
+ * @brief   Decryption operation using AES-GCM.
+ * @note    This is a stream cipher, there are no size restrictions.
+ * @note    Only the first 96 bits of @p iv are used, the counter part is
+ *          initialized by the driver.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[in] key_id            the key to be used for the operation, zero is
  *                              the transient key, other values are keys stored
  *                              in an unspecified way
- * @param[in] size              size of both buffers, this number must be a
- *                              multiple of 16
- * @param[in] in                buffer containing the input plaintext
- * @param[out] out              buffer for the output ciphertext
- * @param[in] iv                128 bits initial vector
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input plaintext
+ * @param[out] text_out         buffer for the output ciphertext
+ * @param[in] iv                128 bits input vector
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[in] tag_in            buffer for the generated authentication tag
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
  * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
@@ -855,46 +2069,61 @@ cryerror_t cry_lld_encrypt_AES_CBC(CRYDriver *cryp,
  * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
  * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
  *                              or refers to an empty key slot.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
  * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
  *                              dependent.
  *
  * @notapi
  */
-cryerror_t cry_lld_decrypt_AES_CBC(CRYDriver *cryp,
+cryerror_t cry_lld_decrypt_AES_GCM(CRYDriver *cryp,
                                    crykey_t key_id,
-                                   size_t size,
-                                   const uint8_t *in,
-                                   uint8_t *out,
-                                   const uint8_t *iv) {
+                                   size_t auth_size,
+                                   const uint8_t *auth_in,
+                                   size_t text_size,
+                                   const uint8_t *text_in,
+                                   uint8_t *text_out,
+                                   const uint8_t *iv,
+                                   size_t tag_size,
+                                   const uint8_t *tag_in) {
+
+  uint32_t tag[4];
+
+  osalDbgCheck((tag_size >= 1U) && (tag_size <= 16U));
+
+  CRYP_ASSERT_NO_JOBS(cryp);
 
   /* Only key zero is supported.*/
   if (key_id != 0U) {
     return CRY_ERR_INV_KEY_ID;
   }
 
-  /* Setting the stored key and IV.*/
-  cryp_set_iv(cryp, iv);
-  if (cryp->cryp_ktype != cryp_key_aes_decrypt) {
-    cryp_set_key_decrypt(cryp, CRYP_CR_ALGOMODE_AES_CBC);
-  }
+  cryp_gcm(cryp, CRYP_CR_ALGODIR, auth_size, auth_in, text_size, text_in,
+           text_out, iv, tag);
 
-  return cryp_do_transfer(cryp, size, in, out);
+  return cryp_aead_check(tag, tag_in, tag_size);
 }
 #endif
 
-#if (CRY_LLD_SUPPORTS_AES_CFB == TRUE) || defined(__DOXYGEN__)
+#if (CRY_LLD_SUPPORTS_AES_CCM == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Encryption operation using AES-CFB.
+ * @brief   Encryption operation using AES-CCM.
  * @note    This is a stream cipher, there are no size restrictions.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[in] key_id            the key to be used for the operation, zero is
  *                              the transient key, other values are keys stored
  *                              in an unspecified way
- * @param[in] size              size of both buffers
- * @param[in] in                buffer containing the input plaintext
- * @param[out] out              buffer for the output ciphertext
- * @param[in] iv                128 bits initial vector
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input plaintext
+ * @param[out] text_out         buffer for the output ciphertext
+ * @param[in] nonce_size        size of the nonce, this number must be between
+ *                              7 and 13
+ * @param[in] nonce             buffer containing the nonce
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be even and between 4 and 16
+ * @param[out] tag_out         buffer for the generated authentication tag
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
  * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
@@ -907,35 +2136,61 @@ cryerror_t cry_lld_decrypt_AES_CBC(CRYDriver *cryp,
  *
  * @notapi
  */
-cryerror_t cry_lld_encrypt_AES_CFB(CRYDriver *cryp,
+cryerror_t cry_lld_encrypt_AES_CCM(CRYDriver *cryp,
                                    crykey_t key_id,
-                                   size_t size,
-                                   const uint8_t *in,
-                                   uint8_t *out,
-                                   const uint8_t *iv) {
+                                   size_t auth_size,
+                                   const uint8_t *auth_in,
+                                   size_t text_size,
+                                   const uint8_t *text_in,
+                                   uint8_t *text_out,
+                                   size_t nonce_size,
+                                   const uint8_t *nonce,
+                                   size_t tag_size,
+                                   uint8_t *tag_out) {
+  uint32_t tag[4];
 
-  (void)cryp;
-  (void)key_id;
-  (void)size;
-  (void)in;
-  (void)out;
-  (void)iv;
+  osalDbgCheck((nonce_size >= 7U) && (nonce_size <= 13U) &&
+               (tag_size >= 4U) && (tag_size <= 16U) &&
+               ((tag_size & 1U) == 0U));
 
-  return CRY_ERR_INV_ALGO;
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  /* Only key zero is supported.*/
+  if (key_id != 0U) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  /* The text size must fit the length field.*/
+  if ((nonce_size > 11U) && ((text_size >> (8U * (15U - nonce_size))) != 0U)) {
+    return CRY_ERR_OP_FAILURE;
+  }
+
+  cryp_ccm(cryp, 0U, auth_size, auth_in, text_size, text_in, text_out,
+           nonce_size, nonce, tag_size, tag);
+  memcpy((void *)tag_out, (const void *)tag, tag_size);
+
+  return CRY_NOERROR;
 }
 
 /**
- * @brief   Decryption operation using AES-CFB.
+ * @brief   Decryption operation using AES-CCM.
  * @note    This is a stream cipher, there are no size restrictions.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[in] key_id            the key to be used for the operation, zero is
  *                              the transient key, other values are keys stored
  *                              in an unspecified way
- * @param[in] size              size of both buffers
- * @param[in] in                buffer containing the input plaintext
- * @param[out] out              buffer for the output ciphertext
- * @param[in] iv                128 bits initial vector
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input ciphertext
+ * @param[out] text_out         buffer for the output plaintext
+ * @param[in] nonce_size        size of the nonce, this number must be between
+ *                              7 and 13
+ * @param[in] nonce             buffer containing the nonce
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be even and between 4 and 16
+ * @param[in] tag_in          buffer for the received authentication tag
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
  * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
@@ -943,223 +2198,335 @@ cryerror_t cry_lld_encrypt_AES_CFB(CRYDriver *cryp,
  * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
  * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
  *                              or refers to an empty key slot.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
  * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
  *                              dependent.
  *
  * @notapi
  */
-cryerror_t cry_lld_decrypt_AES_CFB(CRYDriver *cryp,
+cryerror_t cry_lld_decrypt_AES_CCM(CRYDriver *cryp,
                                    crykey_t key_id,
-                                   size_t size,
-                                   const uint8_t *in,
-                                   uint8_t *out,
-                                   const uint8_t *iv) {
+                                   size_t auth_size,
+                                   const uint8_t *auth_in,
+                                   size_t text_size,
+                                   const uint8_t *text_in,
+                                   uint8_t *text_out,
+                                   size_t nonce_size,
+                                   const uint8_t *nonce,
+                                   size_t tag_size,
+                                   const uint8_t *tag_in) {
+  uint32_t tag[4];
 
-  (void)cryp;
-  (void)key_id;
-  (void)size;
-  (void)in;
-  (void)out;
-  (void)iv;
+  osalDbgCheck((nonce_size >= 7U) && (nonce_size <= 13U) &&
+               (tag_size >= 4U) && (tag_size <= 16U) &&
+               ((tag_size & 1U) == 0U));
 
-  return CRY_ERR_INV_ALGO;
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  /* Only key zero is supported.*/
+  if (key_id != 0U) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  /* The text size must fit the length field.*/
+  if ((nonce_size > 11U) && ((text_size >> (8U * (15U - nonce_size))) != 0U)) {
+    return CRY_ERR_OP_FAILURE;
+  }
+
+#if !defined(CRYP_CR_NPBLB)
+  /* Without NPBLB a partial last block would corrupt the tag.*/
+  if ((text_size % 16U) != 0U) {
+    return CRY_ERR_OP_FAILURE;
+  }
+#endif
+
+  cryp_ccm(cryp, CRYP_CR_ALGODIR, auth_size, auth_in, text_size, text_in,
+           text_out, nonce_size, nonce, tag_size, tag);
+
+  return cryp_aead_check(tag, tag_in, tag_size);
 }
 #endif
 
-#if (CRY_LLD_SUPPORTS_AES_CTR == TRUE) || defined(__DOXYGEN__)
+#if (CRY_LLD_SUPPORTS_AES_STREAM == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Encryption operation using AES-CTR.
- * @note    This is a stream cipher, there are no size restrictions.
+ * @brief   Initializes an AES-CBC streaming context.
+ * @note    The context uses the transient key, it must not be changed
+ *          until the stream is finalized.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] ctxp             pointer to an AES context to be initialized
  * @param[in] key_id            the key to be used for the operation, zero is
  *                              the transient key, other values are keys stored
  *                              in an unspecified way
- * @param[in] size              size of both buffers
- * @param[in] in                buffer containing the input plaintext
- * @param[out] out              buffer for the output ciphertext
- * @param[in] iv                128 bits initial vector + counter, it contains
- *                              a 96 bits IV and a 32 bits counter
+ * @param[in] encrypt           @p true for encryption, @p false for
+ *                              decryption
+ * @param[in] iv                128 bits initial vector
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
- * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
- *                              device instance.
- * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
  * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
  *                              or refers to an empty key slot.
- * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
- *                              dependent.
  *
  * @notapi
  */
-cryerror_t cry_lld_encrypt_AES_CTR(CRYDriver *cryp,
-                                   crykey_t key_id,
-                                   size_t size,
-                                   const uint8_t *in,
-                                   uint8_t *out,
-                                   const uint8_t *iv) {
+cryerror_t cry_lld_AES_CBC_init(CRYDriver *cryp,
+                                AESContext *ctxp,
+                                crykey_t key_id,
+                                bool encrypt,
+                                const uint8_t *iv) {
 
   (void)cryp;
-  (void)key_id;
-  (void)size;
-  (void)in;
-  (void)out;
-  (void)iv;
 
-  return CRY_ERR_INV_ALGO;
+  /* Only key zero is supported.*/
+  if (key_id != 0U) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  cryp_stream_init(ctxp,
+                   CRYP_CR_ALGOMODE_AES_CBC | (encrypt ? 0U : CRYP_CR_ALGODIR),
+                   iv);
+
+  return CRY_NOERROR;
 }
 
 /**
- * @brief   Decryption operation using AES-CTR.
- * @note    This is a stream cipher, there are no size restrictions.
+ * @brief   Initializes an AES-CTR streaming context.
+ * @note    The context uses the transient key, it must not be changed
+ *          until the stream is finalized.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] ctxp             pointer to an AES context to be initialized
  * @param[in] key_id            the key to be used for the operation, zero is
  *                              the transient key, other values are keys stored
  *                              in an unspecified way
- * @param[in] size              size of both buffers
- * @param[in] in                buffer containing the input ciphertext
- * @param[out] out              buffer for the output plaintext
  * @param[in] iv                128 bits initial vector + counter, it contains
  *                              a 96 bits IV and a 32 bits counter
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
- * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
- *                              device instance.
- * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
  * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
  *                              or refers to an empty key slot.
- * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
- *                              dependent.
  *
  * @notapi
  */
-cryerror_t cry_lld_decrypt_AES_CTR(CRYDriver *cryp,
-                                   crykey_t key_id,
-                                   size_t size,
-                                   const uint8_t *in,
-                                   uint8_t *out,
-                                   const uint8_t *iv) {
+cryerror_t cry_lld_AES_CTR_init(CRYDriver *cryp,
+                                AESContext *ctxp,
+                                crykey_t key_id,
+                                const uint8_t *iv) {
 
   (void)cryp;
-  (void)key_id;
-  (void)size;
-  (void)in;
-  (void)out;
-  (void)iv;
 
-  return CRY_ERR_INV_ALGO;
+  /* Only key zero is supported.*/
+  if (key_id != 0U) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  cryp_stream_init(ctxp, CRYP_CR_ALGOMODE_AES_CTR, iv);
+
+  return CRY_NOERROR;
 }
-#endif
 
-#if (CRY_LLD_SUPPORTS_AES_GCM == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Encryption operation using AES-GCM.
- * @note    This is a stream cipher, there are no size restrictions.
+ * @brief   Initializes an AES-GCM streaming context.
+ * @note    The context uses the transient key, it must not be changed
+ *          until the stream is finalized.
+ * @note    The GCM init phase runs here, only the first 96 bits of @p iv
+ *          are used.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] ctxp             pointer to an AES context to be initialized
  * @param[in] key_id            the key to be used for the operation, zero is
  *                              the transient key, other values are keys stored
  *                              in an unspecified way
- * @param[in] auth_size         size of the data buffer to be authenticated
- * @param[in] auth_in           buffer containing the data to be authenticated
- * @param[in] text_size         size of the text buffer
- * @param[in] text_in           buffer containing the input plaintext
- * @param[out] text_out         buffer for the output ciphertext
+ * @param[in] encrypt           @p true for encryption, @p false for
+ *                              decryption
  * @param[in] iv                128 bits input vector
- * @param[in] tag_size          size of the authentication tag, this number
- *                              must be between 1 and 16
- * @param[out] tag_out          buffer for the generated authentication tag
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
- * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
- *                              device instance.
- * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
  * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
  *                              or refers to an empty key slot.
- * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
- *                              dependent.
  *
  * @notapi
  */
-cryerror_t cry_lld_encrypt_AES_GCM(CRYDriver *cryp,
-                                   crykey_t key_id,
-                                   size_t auth_size,
-                                   const uint8_t *auth_in,
-                                   size_t text_size,
-                                   const uint8_t *text_in,
-                                   uint8_t *text_out,
-                                   const uint8_t *iv,
-                                   size_t tag_size,
-                                   uint8_t *tag_out) {
+cryerror_t cry_lld_AES_GCM_init(CRYDriver *cryp,
+                                AESContext *ctxp,
+                                crykey_t key_id,
+                                bool encrypt,
+                                const uint8_t *iv) {
 
-  (void)cryp;
-  (void)key_id;
-  (void)auth_size;
-  (void)auth_in;
-  (void)text_size;
-  (void)text_in;
-  (void)text_out;
-  (void)iv;
-  (void)tag_size;
-  (void)tag_out;
+  CRYP_ASSERT_NO_JOBS(cryp);
 
-  return CRY_ERR_INV_ALGO;
+  /* Only key zero is supported.*/
+  if (key_id != 0U) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  memset((void *)ctxp, 0, sizeof (AESContext));
+  cryp_gcm_init(cryp, encrypt ? 0U : CRYP_CR_ALGODIR, iv);
+  cryp_stream_save(ctxp);
+
+  return CRY_NOERROR;
 }
 
 /**
- * @brief   Decryption operation using AES-GCM.
- * @note    This is a stream cipher, there are no size restrictions.
+ * @brief   Feeds data to be authenticated to an AES-GCM streaming context.
+ * @note    All the authenticated data must be fed before the text, only the
+ *          last chunk can have a size that is not a multiple of 16.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
- * @param[in] key_id            the key to be used for the operation, zero is
- *                              the transient key, other values are keys stored
- *                              in an unspecified way
- * @param[in] auth_size         size of the data buffer to be authenticated
- * @param[in] auth_in           buffer containing the data to be authenticated
- * @param[in] text_size         size of the text buffer
- * @param[in] text_in           buffer containing the input plaintext
- * @param[out] text_out         buffer for the output ciphertext
- * @param[in] iv                128 bits input vector
+ * @param[in,out] ctxp          pointer to an AES-GCM context
+ * @param[in] size              size of the data buffer
+ * @param[in] in                buffer containing the data to be authenticated
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_OP_FAILURE   if the data is out of sequence.
+ *
+ * @notapi
+ */
+cryerror_t cry_lld_AES_GCM_auth(CRYDriver *cryp,
+                                AESContext *ctxp,
+                                size_t size,
+                                const uint8_t *in) {
+
+  osalDbgCheck((ctxp->cr & CRYP_CR_ALGOMODE_Msk) == CRYP_CR_ALGOMODE_AES_GCM);
+
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  /* Nothing can follow the text or a partial block.*/
+  if ((ctxp->text_size != 0U) || ((ctxp->auth_size % 16U) != 0U)) {
+    return CRY_ERR_OP_FAILURE;
+  }
+
+  if (size > 0U) {
+    cryp_stream_restore(cryp, ctxp);
+    cryp_aead_phase(CRYP_CR_GCM_CCMPH_0);
+    cryp_push_header(cryp, size, in);
+    ctxp->auth_size += size;
+    cryp_stream_save(ctxp);
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Processes a chunk of text using an AES streaming context.
+ * @details The chaining state is restored from the context, the key is
+ *          only reloaded if another operation used the unit in between.
+ * @note    For CBC the size must be a multiple of 16. For GCM only the last
+ *          chunk can have a size that is not a multiple of 16. CTR has no
+ *          size restrictions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to an AES context
+ * @param[in] size              size of both buffers
+ * @param[in] in                input buffer
+ * @param[out] out              output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_OP_FAILURE   if the data is out of sequence.
+ *
+ * @notapi
+ */
+cryerror_t cry_lld_AES_update(CRYDriver *cryp,
+                              AESContext *ctxp,
+                              size_t size,
+                              const uint8_t *in,
+                              uint8_t *out) {
+  uint32_t algomode = ctxp->cr & CRYP_CR_ALGOMODE_Msk;
+
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  if (algomode == CRYP_CR_ALGOMODE_AES_CTR) {
+    const uint8_t *ks = (const uint8_t *)ctxp->ks;
+
+    /* Key stream left over by a previous partial block.*/
+    while ((size > 0U) && (ctxp->ks_n > 0U)) {
+      *out++ = *in++ ^ ks[16U - ctxp->ks_n];
+      ctxp->ks_n--;
+      size--;
+    }
+  }
+  else if (algomode == CRYP_CR_ALGOMODE_AES_CBC) {
+    osalDbgCheck((size % 16U) == 0U);
+  }
+  else {
+    /* Nothing can follow a partial block.*/
+    if ((ctxp->text_size % 16U) != 0U) {
+      return CRY_ERR_OP_FAILURE;
+    }
+#if !defined(CRYP_CR_NPBLB)
+    /* Without NPBLB a partial last block would corrupt the tag.*/
+    if (((size % 16U) != 0U) && ((ctxp->cr & CRYP_CR_ALGODIR) == 0U)) {
+      return CRY_ERR_OP_FAILURE;
+    }
+#endif
+  }
+
+  if (size == 0U) {
+    return CRY_NOERROR;
+  }
+
+  cryp_stream_restore(cryp, ctxp);
+  if (algomode == CRYP_CR_ALGOMODE_AES_GCM) {
+    cryp_aead_phase(CRYP_CR_GCM_CCMPH_1);
+    cryp_aead_payload(cryp, size, in, out,
+                      (ctxp->cr & CRYP_CR_ALGODIR) == 0U);
+    ctxp->text_size += size;
+  }
+  else if (algomode == CRYP_CR_ALGOMODE_AES_CTR) {
+    cryp_ctr_transfer(cryp, size, in, out, ctxp->ks);
+    ctxp->ks_n = (16U - (uint32_t)(size % 16U)) % 16U;
+  }
+  else {
+    cryp_exchange(cryp, size, in, out);
+  }
+  cryp_stream_save(ctxp);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Finalizes an AES streaming context.
+ * @details For GCM the tag is generated when encrypting or verified when
+ *          decrypting. The context is cleared in any case.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to an AES context
  * @param[in] tag_size          size of the authentication tag, this number
- *                              must be between 1 and 16
- * @param[in] tag_in            buffer for the generated authentication tag
+ *                              must be between 1 and 16, ignored for CBC
+ *                              and CTR
+ * @param[in,out] tag           buffer for the generated authentication tag
+ *                              or the received one when decrypting
  * @return                      The operation status.
  * @retval CRY_NOERROR          if the operation succeeded.
- * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
- *                              device instance.
- * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
- * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
- *                              or refers to an empty key slot.
  * @retval CRY_ERR_AUTH_FAILED  authentication failed
- * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
- *                              dependent.
  *
  * @notapi
  */
-cryerror_t cry_lld_decrypt_AES_GCM(CRYDriver *cryp,
-                                   crykey_t key_id,
-                                   size_t auth_size,
-                                   const uint8_t *auth_in,
-                                   size_t text_size,
-                                   const uint8_t *text_in,
-                                   uint8_t *text_out,
-                                   const uint8_t *iv,
-                                   size_t tag_size,
-                                   const uint8_t *tag_in) {
+cryerror_t cry_lld_AES_final(CRYDriver *cryp,
+                             AESContext *ctxp,
+                             size_t tag_size,
+                             uint8_t *tag) {
+  cryerror_t err = CRY_NOERROR;
+  uint32_t t[4];
+
+  CRYP_ASSERT_NO_JOBS(cryp);
+
+  if ((ctxp->cr & CRYP_CR_ALGOMODE_Msk) == CRYP_CR_ALGOMODE_AES_GCM) {
+    osalDbgCheck((tag_size >= 1U) && (tag_size <= 16U));
+
+    cryp_stream_restore(cryp, ctxp);
+    cryp_gcm_final(ctxp->auth_size, ctxp->text_size, t);
+    if ((ctxp->cr & CRYP_CR_ALGODIR) == 0U) {
+      memcpy((void *)tag, (const void *)t, tag_size);
+    }
+    else {
+      err = cryp_aead_check(t, tag, tag_size);
+    }
+  }
 
-  (void)cryp;
-  (void)key_id;
-  (void)auth_size;
-  (void)auth_in;
-  (void)text_size;
-  (void)text_in;
-  (void)text_out;
-  (void)iv;
-  (void)tag_size;
-  (void)tag_in;
+  /* The chaining state and the key stream are not left around.*/
+  memset((void *)ctxp, 0, sizeof (AESContext));
 
-  return CRY_ERR_INV_ALGO;
+  return err;
 }
 #endif
 
@@ -1533,11 +2900,14 @@ cryerror_t cry_lld_SHA1_final(CRYDriver *cryp, SHA1Context *sha1ctxp,
  */
 cryerror_t cry_lld_SHA256_init(CRYDriver *cryp, SHA256Context *sha256ctxp) {
 
-  (void)cryp;
+  HASH_ASSERT_NO_JOBS(cryp);
 
   /* Initializing context structure.*/
-  sha256ctxp->last_data = 0U;
-  sha256ctxp->last_size = 0U;
+  sha256ctxp->carry_data = 0U;
+  sha256ctxp->carry_size = 0U;
+
+  /* Taking the unit, the previous owner state is saved.*/
+  hash_acquire(cryp, &sha256ctxp->hash_state, false);
 
   /* Initializing operation.*/
   HASH->CR = /* HASH_CR_MDMAT |*/ HASH_CR_ALGO_1 | HASH_CR_ALGO_0 |
@@ -1548,6 +2918,8 @@ cryerror_t cry_lld_SHA256_init(CRYDriver *cryp, SHA256Context *sha256ctxp) {
 
 /**
  * @brief   Hash update using SHA256.
+ * @note    There are no size or alignment restrictions, word aligned data
+ *          above the threshold is pushed using DMA.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[in] sha256ctxp        pointer to a SHA256 context
@@ -1564,23 +2936,53 @@ cryerror_t cry_lld_SHA256_init(CRYDriver *cryp, SHA256Context *sha256ctxp) {
  */
 cryerror_t cry_lld_SHA256_update(CRYDriver *cryp, SHA256Context *sha256ctxp,
                                  size_t size, const uint8_t *in) {
-  const uint32_t *wp = (const uint32_t *)(const void *)in;
+  uint8_t *cp = (uint8_t *)&sha256ctxp->carry_data;
+  size_t n;
 
-  /* This HW is unable to hash blocks that are not a multiple of 4 bytes
-     except for the last block in the stream which is handled in the
-     "final" function.*/
-  if (sha256ctxp->last_size != 0U) {
-    return CRY_ERR_OP_FAILURE;
+  HASH_ASSERT_NO_JOBS(cryp);
+
+  /* This HW only accepts whole words, bytes left over by the previous
+     update are completed first.*/
+  if (sha256ctxp->carry_size > 0U) {
+    while ((size > 0U) && (sha256ctxp->carry_size < 4U)) {
+      cp[sha256ctxp->carry_size++] = *in++;
+      size--;
+    }
+    if (sha256ctxp->carry_size < 4U) {
+      /* Still incomplete, the unit is not touched.*/
+      return CRY_NOERROR;
+    }
+  }
+
+  hash_acquire(cryp, &sha256ctxp->hash_state, true);
+  if (sha256ctxp->carry_size > 0U) {
+    HASH->DIN = sha256ctxp->carry_data;
+    sha256ctxp->carry_data = 0U;
+    sha256ctxp->carry_size = 0U;
   }
 
-  /* Any unaligned data is deferred to the "final" function.*/
-  sha256ctxp->last_size = 8U * (size % sizeof (uint32_t));
-  if (sha256ctxp->last_size > 0U) {
-    sha256ctxp->last_data = wp[size / sizeof (uint32_t)];
+  /* Pushing whole words, only aligned data can go through DMA.*/
+  n = size / sizeof (uint32_t);
+  if (n > 0U) {
+    if (((uint32_t)in & 3U) == 0U) {
+      cry_lld_hash_push(cryp, (uint32_t)n, (const uint32_t *)(const void *)in);
+      in += n * sizeof (uint32_t);
+    }
+    else {
+      do {
+        HASH->DIN = __UNALIGNED_UINT32_READ(in);
+        in += sizeof (uint32_t);
+        n--;
+      } while (n > 0U);
+    }
+    size %= sizeof (uint32_t);
   }
 
-  /* Pushing data.*/
-  cry_lld_hash_push(cryp, (uint32_t)(size / sizeof (uint32_t)), wp);
+  /* Trailing bytes are kept for the next update or the final.*/
+  while (size > 0U) {
+    cp[sha256ctxp->carry_size++] = *in++;
+    size--;
+  }
 
   return CRY_NOERROR;
 }
@@ -1602,31 +3004,11 @@ cryerror_t cry_lld_SHA256_update(CRYDriver *cryp, SHA256Context *sha256ctxp,
  */
 cryerror_t cry_lld_SHA256_final(CRYDriver *cryp, SHA256Context *sha256ctxp,
                                 uint8_t *out) {
-  uint32_t digest[8];
-
-  (void)cryp;
 
-  if (sha256ctxp->last_size > 0U) {
-    HASH->DIN = sha256ctxp->last_data;
-  }
-
-  /* Triggering final calculation and wait for result.*/
-  HASH->SR  = 0U;
-  HASH->STR = sha256ctxp->last_size;
-  HASH->STR = sha256ctxp->last_size | HASH_STR_DCAL;
-  while ((HASH->SR & HASH_SR_DCIS) == 0U) {
-  }
+  HASH_ASSERT_NO_JOBS(cryp);
 
-  /* Reading digest.*/
-  digest[0] = HASH_DIGEST->HR[0];
-  digest[1] = HASH_DIGEST->HR[1];
-  digest[2] = HASH_DIGEST->HR[2];
-  digest[3] = HASH_DIGEST->HR[3];
-  digest[4] = HASH_DIGEST->HR[4];
-  digest[5] = HASH_DIGEST->HR[5];
-  digest[6] = HASH_DIGEST->HR[6];
-  digest[7] = HASH_DIGEST->HR[7];
-  memcpy((void *)out, (const void *)digest, sizeof digest);
+  hash_acquire(cryp, &sha256ctxp->hash_state, true);
+  hash_sha256_final(cryp, sha256ctxp, out);
 
   return CRY_NOERROR;
 }
@@ -1896,6 +3278,432 @@ cryerror_t cry_lld_HMACSHA512_final(CRYDriver *cryp,
 }
 #endif
 
+#if (CRY_LLD_SUPPORTS_AES_CCM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Encryption operation using AES-CCM.
+ * @details See @p cry_lld_encrypt_AES_CCM().
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input plaintext
+ * @param[out] text_out         buffer for the output ciphertext
+ * @param[in] nonce_size        size of the nonce, this number must be between
+ *                              7 and 13
+ * @param[in] nonce             buffer containing the nonce
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be even and between 4 and 16
+ * @param[out] tag_out          buffer for the generated authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @api
+ */
+cryerror_t crySTM32EncryptAES_CCM(CRYDriver *cryp,
+                                  crykey_t key_id,
+                                  size_t auth_size,
+                                  const uint8_t *auth_in,
+                                  size_t text_size,
+                                  const uint8_t *text_in,
+                                  uint8_t *text_out,
+                                  size_t nonce_size,
+                                  const uint8_t *nonce,
+                                  size_t tag_size,
+                                  uint8_t *tag_out) {
+
+  osalDbgCheck((cryp != NULL) &&
+               ((auth_size == 0U) || (auth_in != NULL)) &&
+               ((text_size == 0U) || ((text_in != NULL) &&
+                                      (text_out != NULL))) &&
+               (nonce != NULL) && (tag_out != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  return cry_lld_encrypt_AES_CCM(cryp, key_id, auth_size, auth_in,
+                                 text_size, text_in, text_out,
+                                 nonce_size, nonce, tag_size, tag_out);
+}
+
+/**
+ * @brief   Decryption operation using AES-CCM.
+ * @details See @p cry_lld_decrypt_AES_CCM().
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input ciphertext
+ * @param[out] text_out         buffer for the output plaintext
+ * @param[in] nonce_size        size of the nonce, this number must be between
+ *                              7 and 13
+ * @param[in] nonce             buffer containing the nonce
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be even and between 4 and 16
+ * @param[in] tag_in            buffer containing the received authentication
+ *                              tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
+ *
+ * @api
+ */
+cryerror_t crySTM32DecryptAES_CCM(CRYDriver *cryp,
+                                  crykey_t key_id,
+                                  size_t auth_size,
+                                  const uint8_t *auth_in,
+                                  size_t text_size,
+                                  const uint8_t *text_in,
+                                  uint8_t *text_out,
+                                  size_t nonce_size,
+                                  const uint8_t *nonce,
+                                  size_t tag_size,
+                                  const uint8_t *tag_in) {
+
+  osalDbgCheck((cryp != NULL) &&
+               ((auth_size == 0U) || (auth_in != NULL)) &&
+               ((text_size == 0U) || ((text_in != NULL) &&
+                                      (text_out != NULL))) &&
+               (nonce != NULL) && (tag_in != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  return cry_lld_decrypt_AES_CCM(cryp, key_id, auth_size, auth_in,
+                                 text_size, text_in, text_out,
+                                 nonce_size, nonce, tag_size, tag_in);
+}
+#endif
+
+#if (CRY_LLD_SUPPORTS_AES_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes an AES-CBC streaming context.
+ * @details See @p cry_lld_AES_CBC_init().
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] ctxp             pointer to an AES context to be initialized
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] encrypt           @p true for encryption, @p false for
+ *                              decryption
+ * @param[in] iv                128 bits initial vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @api
+ */
+cryerror_t crySTM32InitAES_CBC(CRYDriver *cryp,
+                               AESContext *ctxp,
+                               crykey_t key_id,
+                               bool encrypt,
+                               const uint8_t *iv) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) && (iv != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  return cry_lld_AES_CBC_init(cryp, ctxp, key_id, encrypt, iv);
+}
+
+/**
+ * @brief   Initializes an AES-CTR streaming context.
+ * @details See @p cry_lld_AES_CTR_init().
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] ctxp             pointer to an AES context to be initialized
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] iv                128 bits initial vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @api
+ */
+cryerror_t crySTM32InitAES_CTR(CRYDriver *cryp,
+                               AESContext *ctxp,
+                               crykey_t key_id,
+                               const uint8_t *iv) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) && (iv != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  return cry_lld_AES_CTR_init(cryp, ctxp, key_id, iv);
+}
+
+/**
+ * @brief   Initializes an AES-GCM streaming context.
+ * @details See @p cry_lld_AES_GCM_init().
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] ctxp             pointer to an AES context to be initialized
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] encrypt           @p true for encryption, @p false for
+ *                              decryption
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @api
+ */
+cryerror_t crySTM32InitAES_GCM(CRYDriver *cryp,
+                               AESContext *ctxp,
+                               crykey_t key_id,
+                               bool encrypt,
+                               const uint8_t *iv) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) && (iv != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  return cry_lld_AES_GCM_init(cryp, ctxp, key_id, encrypt, iv);
+}
+
+/**
+ * @brief   Feeds data to be authenticated to an AES-GCM streaming context.
+ * @details See @p cry_lld_AES_GCM_auth().
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to an AES-GCM context
+ * @param[in] size              size of the data buffer
+ * @param[in] in                buffer containing the data to be authenticated
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_OP_FAILURE   if the data is out of sequence.
+ *
+ * @api
+ */
+cryerror_t crySTM32AuthAES_GCM(CRYDriver *cryp,
+                               AESContext *ctxp,
+                               size_t size,
+                               const uint8_t *in) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) &&
+               ((size == 0U) || (in != NULL)));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  return cry_lld_AES_GCM_auth(cryp, ctxp, size, in);
+}
+
+/**
+ * @brief   Processes a chunk of text using an AES streaming context.
+ * @details See @p cry_lld_AES_update().
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to an AES context
+ * @param[in] size              size of both buffers
+ * @param[in] in                input buffer
+ * @param[out] out              output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_OP_FAILURE   if the data is out of sequence.
+ *
+ * @api
+ */
+cryerror_t crySTM32UpdateAES(CRYDriver *cryp,
+                             AESContext *ctxp,
+                             size_t size,
+                             const uint8_t *in,
+                             uint8_t *out) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) &&
+               ((size == 0U) || ((in != NULL) && (out != NULL))));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  return cry_lld_AES_update(cryp, ctxp, size, in, out);
+}
+
+/**
+ * @brief   Finalizes an AES streaming context.
+ * @details See @p cry_lld_AES_final().
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to an AES context
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16, ignored for CBC
+ *                              and CTR
+ * @param[in,out] tag           buffer for the generated authentication tag
+ *                              or the received one when decrypting, can be
+ *                              @p NULL for CBC and CTR
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
+ *
+ * @api
+ */
+cryerror_t crySTM32FinalAES(CRYDriver *cryp,
+                            AESContext *ctxp,
+                            size_t tag_size,
+                            uint8_t *tag) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) &&
+               ((tag != NULL) ||
+                ((ctxp->cr & CRYP_CR_ALGOMODE_Msk) !=
+                 CRYP_CR_ALGOMODE_AES_GCM)));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  return cry_lld_AES_final(cryp, ctxp, tag_size, tag);
+}
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA256 == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Releases a SHA256 context without finalizing it.
+ * @details The driver no longer references the context after this call,
+ *          it must be used on error paths before the context memory is
+ *          reused or goes out of scope.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] sha256ctxp    pointer to a SHA256 context
+ *
+ * @api
+ */
+void crySTM32ReleaseSHA256(CRYDriver *cryp, SHA256Context *sha256ctxp) {
+
+  osalDbgCheck((cryp != NULL) && (sha256ctxp != NULL));
+
+  osalDbgAssert((cryp->state == CRY_STOP) || (cryp->state == CRY_READY),
+                "invalid state");
+  HASH_ASSERT_NO_JOBS(cryp);
+
+  if (cryp->hash_owner == &sha256ctxp->hash_state) {
+    cryp->hash_owner = NULL;
+  }
+  memset((void *)sha256ctxp, 0, sizeof (SHA256Context));
+}
+#endif
+
+#if (STM32_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+#if (STM32_CRY_USE_CRYP1 == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief   Queues an AES job.
+ * @details If the queue is idle the job is started immediately, else it is
+ *          started from the completion interrupt of the previous one
+ *          without thread intervention.
+ * @note    The job uses the transient key loaded when it starts, the key
+ *          must not be changed while jobs are pending.
+ * @note    Synchronous CRYP operations must not be started while jobs are
+ *          pending, this is asserted when the debug checks are enabled.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] jp                pointer to the job descriptor
+ *
+ * @iclass
+ */
+void crySTM32QueueAESI(CRYDriver *cryp, cry_aes_job_t *jp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((cryp != NULL) && (jp != NULL) &&
+               (jp->size > 0U) && ((jp->size & 15U) == 0U) &&
+               (jp->size < 0x10000U * 4U) &&
+               ((jp->op < cry_aes_cbc_encrypt) || (jp->iv != NULL)));
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  jp->next = NULL;
+  if (cryp->cryp_job_head == NULL) {
+    cryp->cryp_job_head = jp;
+    cryp->cryp_job_tail = jp;
+    cryp_job_start(cryp);
+  }
+  else {
+    cryp->cryp_job_tail->next = jp;
+    cryp->cryp_job_tail       = jp;
+  }
+}
+
+/**
+ * @brief   Queues an AES job.
+ * @details See @p crySTM32QueueAESI().
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] jp                pointer to the job descriptor
+ *
+ * @api
+ */
+void crySTM32QueueAES(CRYDriver *cryp, cry_aes_job_t *jp) {
+
+  osalSysLock();
+  crySTM32QueueAESI(cryp, jp);
+  osalSysUnlock();
+}
+#endif
+
+#if (STM32_CRY_USE_HASH1 == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief   Queues a SHA256 job.
+ * @details If the queue is idle the job is started immediately, else it is
+ *          started from the completion interrupt of the previous one
+ *          without thread intervention. Jobs of different contexts can be
+ *          interleaved, the HASH state is swapped as needed.
+ * @note    Synchronous hash operations must not be started while jobs are
+ *          pending, this is asserted when the debug checks are enabled.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] jp                pointer to the job descriptor
+ *
+ * @iclass
+ */
+void crySTM32QueueSHA256I(CRYDriver *cryp, cry_hash_job_t *jp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((cryp != NULL) && (jp != NULL) && (jp->sha256ctxp != NULL) &&
+               (jp->size >= sizeof (uint32_t)) &&
+               (((uint32_t)jp->in & 3U) == 0U));
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  jp->next = NULL;
+  if (cryp->hash_job_head == NULL) {
+    cryp->hash_job_head = jp;
+    cryp->hash_job_tail = jp;
+    hash_job_start(cryp);
+  }
+  else {
+    cryp->hash_job_tail->next = jp;
+    cryp->hash_job_tail       = jp;
+  }
+}
+
+/**
+ * @brief   Queues a SHA256 job.
+ * @details See @p crySTM32QueueSHA256I().
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] jp                pointer to the job descriptor
+ *
+ * @api
+ */
+void crySTM32QueueSHA256(CRYDriver *cryp, cry_hash_job_t *jp) {
+
+  osalSysLock();
+  crySTM32QueueSHA256I(cryp, jp);
+  osalSysUnlock();
+}
+#endif
+#endif /* STM32_CRY_USE_QUEUE == TRUE */
+
 #endif /* HAL_USE_CRY == TRUE */
 
 /** @} */
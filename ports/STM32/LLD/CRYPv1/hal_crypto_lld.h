@@ -31,6 +31,11 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of HASH_CSRx context swap registers.
+ */
+#define STM32_HASH_CSR_NUM                  54U
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -120,6 +125,17 @@
 #if !defined(STM32_CRY_CRYP_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
 #define STM32_CRY_CRYP_DMA_ERROR_HOOK(cryp) osalSysHalt("DMA failure")
 #endif
+
+/**
+ * @brief   Job queue support.
+ * @details If set to @p TRUE the @p crySTM32QueueAES() and
+ *          @p crySTM32QueueSHA256() APIs are included, queued jobs are
+ *          chained back to back from the DMA completion interrupts.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_CRY_USE_QUEUE) || defined(__DOXYGEN__)
+#define STM32_CRY_USE_QUEUE                 FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -217,6 +233,16 @@
 #error "invalid STM32_CRY_HASH_SIZE_THRESHOLD value"
 #endif
 
+#if STM32_CRY_USE_QUEUE && STM32_CRY_USE_CRYP1 &&                           \
+    (STM32_CRY_CRYP_SIZE_THRESHOLD == 0)
+#error "STM32_CRY_USE_QUEUE requires DMA on CRYP1"
+#endif
+
+#if STM32_CRY_USE_QUEUE && STM32_CRY_USE_HASH1 &&                           \
+    (STM32_CRY_HASH_SIZE_THRESHOLD == 0)
+#error "STM32_CRY_USE_QUEUE requires DMA on HASH1"
+#endif
+
 /**
  * @name    Driver capability switches
  * @{
@@ -228,6 +254,8 @@
 #define CRY_LLD_SUPPORTS_AES_CFB            FALSE
 #define CRY_LLD_SUPPORTS_AES_CTR            TRUE
 #define CRY_LLD_SUPPORTS_AES_GCM            TRUE
+#define CRY_LLD_SUPPORTS_AES_CCM            TRUE
+#define CRY_LLD_SUPPORTS_AES_STREAM         TRUE
 #define CRY_LLD_SUPPORTS_DES                TRUE
 #define CRY_LLD_SUPPORTS_DES_ECB            TRUE
 #define CRY_LLD_SUPPORTS_DES_CBC            TRUE
@@ -238,6 +266,8 @@
 #define CRY_LLD_SUPPORTS_AES_CFB            FALSE
 #define CRY_LLD_SUPPORTS_AES_CTR            FALSE
 #define CRY_LLD_SUPPORTS_AES_GCM            FALSE
+#define CRY_LLD_SUPPORTS_AES_CCM            FALSE
+#define CRY_LLD_SUPPORTS_AES_STREAM         FALSE
 #define CRY_LLD_SUPPORTS_DES                FALSE
 #define CRY_LLD_SUPPORTS_DES_ECB            FALSE
 #define CRY_LLD_SUPPORTS_DES_CBC            FALSE
@@ -282,6 +312,62 @@ typedef enum {
   cryp_key_aes_decrypt = 4
 } cryp_ktype_t;
 
+#if (STM32_CRY_USE_HASH1 == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief   Saved state of the HASH unit.
+ */
+typedef struct {
+  /**
+   * @brief   HASH_IMR register.
+   */
+  uint32_t                  imr;
+  /**
+   * @brief   HASH_STR register.
+   */
+  uint32_t                  str;
+  /**
+   * @brief   HASH_CR register.
+   */
+  uint32_t                  cr;
+  /**
+   * @brief   HASH_CSRx registers.
+   */
+  uint32_t                  csr[STM32_HASH_CSR_NUM];
+  /**
+   * @brief   Points to this structure while it owns the unit.
+   * @note    Used to detect storage reused without being released.
+   */
+  const void                *self;
+} stm32_hash_state_t;
+#endif
+
+#if (STM32_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+#if (STM32_CRY_USE_CRYP1 == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief   Operation of a queued AES job.
+ */
+typedef enum {
+  cry_aes_ecb_encrypt = 0,
+  cry_aes_ecb_decrypt = 1,
+  cry_aes_cbc_encrypt = 2,
+  cry_aes_cbc_decrypt = 3,
+  cry_aes_ctr = 4
+} cry_aes_op_t;
+
+/**
+ * @brief   Type of a queued AES job.
+ */
+typedef struct cry_aes_job cry_aes_job_t;
+#endif
+
+#if (STM32_CRY_USE_HASH1 == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief   Type of a queued hash job.
+ */
+typedef struct cry_hash_job cry_hash_job_t;
+#endif
+#endif /* STM32_CRY_USE_QUEUE == TRUE */
+
 /**
  * @brief   Driver configuration structure.
  * @note    It could be empty on some architectures.
@@ -332,9 +418,24 @@ struct CRYDriver {
    * @brief   CRYP OUT DMA stream.
    */
   const stm32_dma_stream_t  *cryp_dma_out;
+#if (STM32_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   AES job in progress, @p NULL if the queue is empty.
+   */
+  cry_aes_job_t             *cryp_job_head;
+  /**
+   * @brief   Last queued AES job.
+   */
+  cry_aes_job_t             *cryp_job_tail;
+#endif
 #endif /* STM32_CRY_CRYP_SIZE_THRESHOLD != 0 */
 #endif /* STM32_CRY_USE_CRYP1 == TRUE */
 #if (STM32_CRY_USE_HASH1 == TRUE) || defined (__DOXYGEN__)
+  /**
+   * @brief   State storage of the context currently loaded in HASH.
+   * @note    @p NULL if no context owns the unit.
+   */
+  stm32_hash_state_t        *hash_owner;
 #if (STM32_CRY_HASH_SIZE_THRESHOLD != 0) || defined (__DOXYGEN__)
   /**
    * @brief   Thread reference for hash operations.
@@ -344,10 +445,66 @@ struct CRYDriver {
    * @brief   Hash DMA stream.
    */
   const stm32_dma_stream_t  *hash_dma;
+#if (STM32_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Hash job in progress, @p NULL if the queue is empty.
+   */
+  cry_hash_job_t            *hash_job_head;
+  /**
+   * @brief   Last queued hash job.
+   */
+  cry_hash_job_t            *hash_job_tail;
+  /**
+   * @brief   Next word of the hash job in progress.
+   */
+  const uint32_t            *hash_job_p;
+  /**
+   * @brief   Words of the hash job still to be pushed.
+   */
+  uint32_t                  hash_job_n;
+#endif
 #endif /* STM32_CRY_HASH_SIZE_THRESHOLD != 0 */
 #endif /* STM32_CRY_USE_HASH1 == TRUE */
 };
 
+#if (CRY_LLD_SUPPORTS_AES_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of an AES streaming context.
+ * @details Holds the chaining state of a CBC, CTR or GCM stream between
+ *          calls, the key itself is not part of the context.
+ */
+typedef struct {
+  /**
+   * @brief   CR register, mode, direction and GCM phase.
+   */
+  uint32_t      cr;
+  /**
+   * @brief   IV registers, the chaining state.
+   */
+  uint32_t      iv[4];
+  /**
+   * @brief   CSGCMCCMxR and CSGCMxR registers, GCM only.
+   */
+  uint32_t      csgcm[16];
+  /**
+   * @brief   Key stream block of the last partial CTR block.
+   */
+  uint32_t      ks[4];
+  /**
+   * @brief   Number of unused bytes at the end of @p ks.
+   */
+  uint32_t      ks_n;
+  /**
+   * @brief   Size of the authenticated data so far, GCM only.
+   */
+  size_t        auth_size;
+  /**
+   * @brief   Size of the text so far, GCM only.
+   */
+  size_t        text_size;
+} AESContext;
+#endif
+
 #if (CRY_LLD_SUPPORTS_SHA1 == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Type of a SHA1 context.
@@ -360,16 +517,24 @@ typedef struct {
 #if (CRY_LLD_SUPPORTS_SHA256 == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Type of a SHA256 context.
+ * @note    Several contexts can be in progress at the same time, the HASH
+ *          state is swapped when a different context uses the unit. A
+ *          context must be finalized, or released using
+ *          @p crySTM32ReleaseSHA256(), before its memory is reused.
  */
 typedef struct {
   /**
-   * @brief   Last data to be hashed on finalization.
+   * @brief   HASH state while another context owns the unit.
+   */
+  stm32_hash_state_t    hash_state;
+  /**
+   * @brief   Bytes waiting to complete a word.
    */
-  uint32_t      last_data;
+  uint32_t      carry_data;
   /**
-   * @brief   Size, in bits, of the last data.
+   * @brief   Number of valid bytes in @p carry_data.
    */
-  uint32_t      last_size;
+  uint32_t      carry_size;
 } SHA256Context;
 #endif
 
@@ -400,6 +565,106 @@ typedef struct {
 } HMACSHA512Context;
 #endif
 
+#if (STM32_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+#if (STM32_CRY_USE_CRYP1 == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief   AES job completion callback type.
+ * @note    The callback is invoked from ISR context with the system locked,
+ *          only I-class functions can be used.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] jp        pointer to the completed job, it can be queued
+ *                      again from within the callback
+ */
+typedef void (*cryaesjobcb_t)(CRYDriver *cryp, cry_aes_job_t *jp);
+
+/**
+ * @brief   Queued AES job descriptor.
+ * @note    The descriptor belongs to the driver from the moment it is
+ *          queued until its callback is invoked.
+ */
+struct cry_aes_job {
+  /**
+   * @brief   Next queued job, managed by the driver.
+   */
+  cry_aes_job_t             *next;
+  /**
+   * @brief   Operation, the transient key is used.
+   */
+  cry_aes_op_t              op;
+  /**
+   * @brief   Initial vector, ignored in ECB mode.
+   */
+  const uint8_t             *iv;
+  /**
+   * @brief   Size of both buffers.
+   * @note    It must be a multiple of 16 and below the DMA limit.
+   */
+  size_t                    size;
+  /**
+   * @brief   Input buffer.
+   */
+  const uint8_t             *in;
+  /**
+   * @brief   Output buffer.
+   */
+  uint8_t                   *out;
+  /**
+   * @brief   Completion callback, can be @p NULL.
+   */
+  cryaesjobcb_t             cb;
+};
+#endif
+
+#if (STM32_CRY_USE_HASH1 == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief   Hash job completion callback type.
+ * @note    The callback is invoked from ISR context with the system locked,
+ *          only I-class functions can be used.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] jp        pointer to the completed job, it can be queued
+ *                      again from within the callback
+ */
+typedef void (*cryhashjobcb_t)(CRYDriver *cryp, cry_hash_job_t *jp);
+
+/**
+ * @brief   Queued hash job descriptor.
+ * @note    The descriptor belongs to the driver from the moment it is
+ *          queued until its callback is invoked.
+ */
+struct cry_hash_job {
+  /**
+   * @brief   Next queued job, managed by the driver.
+   */
+  cry_hash_job_t            *next;
+  /**
+   * @brief   Context, initialized by @p cry_lld_SHA256_init().
+   */
+  SHA256Context             *sha256ctxp;
+  /**
+   * @brief   Size of the input buffer, at least one word.
+   * @note    Only the last job of a context can have a size which is not
+   *          a multiple of four.
+   */
+  size_t                    size;
+  /**
+   * @brief   Input buffer, it must be word aligned.
+   */
+  const uint8_t             *in;
+  /**
+   * @brief   256 bits output buffer, @p NULL if the context is not
+   *          finalized by this job.
+   */
+  uint8_t                   *out;
+  /**
+   * @brief   Completion callback, can be @p NULL.
+   */
+  cryhashjobcb_t            cb;
+};
+#endif
+#endif /* STM32_CRY_USE_QUEUE == TRUE */
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -424,6 +689,8 @@ extern "C" {
     (CRY_LLD_SUPPORTS_AES_CFB == TRUE) ||                                   \
     (CRY_LLD_SUPPORTS_AES_CTR == TRUE) ||                                   \
     (CRY_LLD_SUPPORTS_AES_GCM == TRUE) ||                                   \
+    (CRY_LLD_SUPPORTS_AES_CCM == TRUE) ||                                   \
+    (CRY_LLD_SUPPORTS_AES_STREAM == TRUE) ||                                \
     defined(__DOXYGEN__)
   cryerror_t cry_lld_aes_loadkey(CRYDriver *cryp,
                                  size_t size,
@@ -515,6 +782,59 @@ extern "C" {
                                      size_t tag_size,
                                      const uint8_t *tag_in);
 #endif
+#if (CRY_LLD_SUPPORTS_AES_CCM == TRUE) || defined(__DOXYGEN__)
+  cryerror_t cry_lld_encrypt_AES_CCM(CRYDriver *cryp,
+                                     crykey_t key_id,
+                                     size_t auth_size,
+                                     const uint8_t *auth_in,
+                                     size_t text_size,
+                                     const uint8_t *text_in,
+                                     uint8_t *text_out,
+                                     size_t nonce_size,
+                                     const uint8_t *nonce,
+                                     size_t tag_size,
+                                     uint8_t *tag_out);
+  cryerror_t cry_lld_decrypt_AES_CCM(CRYDriver *cryp,
+                                     crykey_t key_id,
+                                     size_t auth_size,
+                                     const uint8_t *auth_in,
+                                     size_t text_size,
+                                     const uint8_t *text_in,
+                                     uint8_t *text_out,
+                                     size_t nonce_size,
+                                     const uint8_t *nonce,
+                                     size_t tag_size,
+                                     const uint8_t *tag_in);
+#endif
+#if (CRY_LLD_SUPPORTS_AES_STREAM == TRUE) || defined(__DOXYGEN__)
+  cryerror_t cry_lld_AES_CBC_init(CRYDriver *cryp,
+                                  AESContext *ctxp,
+                                  crykey_t key_id,
+                                  bool encrypt,
+                                  const uint8_t *iv);
+  cryerror_t cry_lld_AES_CTR_init(CRYDriver *cryp,
+                                  AESContext *ctxp,
+                                  crykey_t key_id,
+                                  const uint8_t *iv);
+  cryerror_t cry_lld_AES_GCM_init(CRYDriver *cryp,
+                                  AESContext *ctxp,
+                                  crykey_t key_id,
+                                  bool encrypt,
+                                  const uint8_t *iv);
+  cryerror_t cry_lld_AES_GCM_auth(CRYDriver *cryp,
+                                  AESContext *ctxp,
+                                  size_t size,
+                                  const uint8_t *in);
+  cryerror_t cry_lld_AES_update(CRYDriver *cryp,
+                                AESContext *ctxp,
+                                size_t size,
+                                const uint8_t *in,
+                                uint8_t *out);
+  cryerror_t cry_lld_AES_final(CRYDriver *cryp,
+                               AESContext *ctxp,
+                               size_t tag_size,
+                               uint8_t *tag);
+#endif
 #if (CRY_LLD_SUPPORTS_DES == TRUE) ||                                       \
     (CRY_LLD_SUPPORTS_DES_ECB == TRUE) ||                                   \
     (CRY_LLD_SUPPORTS_DES_CBC == TRUE) ||                                   \
@@ -607,6 +927,72 @@ extern "C" {
                                       HMACSHA512Context *hmacsha512ctxp,
                                       uint8_t *out);
 #endif
+#if (CRY_LLD_SUPPORTS_AES_CCM == TRUE) || defined(__DOXYGEN__)
+  cryerror_t crySTM32EncryptAES_CCM(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    size_t auth_size,
+                                    const uint8_t *auth_in,
+                                    size_t text_size,
+                                    const uint8_t *text_in,
+                                    uint8_t *text_out,
+                                    size_t nonce_size,
+                                    const uint8_t *nonce,
+                                    size_t tag_size,
+                                    uint8_t *tag_out);
+  cryerror_t crySTM32DecryptAES_CCM(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    size_t auth_size,
+                                    const uint8_t *auth_in,
+                                    size_t text_size,
+                                    const uint8_t *text_in,
+                                    uint8_t *text_out,
+                                    size_t nonce_size,
+                                    const uint8_t *nonce,
+                                    size_t tag_size,
+                                    const uint8_t *tag_in);
+#endif
+#if (CRY_LLD_SUPPORTS_AES_STREAM == TRUE) || defined(__DOXYGEN__)
+  cryerror_t crySTM32InitAES_CBC(CRYDriver *cryp,
+                                 AESContext *ctxp,
+                                 crykey_t key_id,
+                                 bool encrypt,
+                                 const uint8_t *iv);
+  cryerror_t crySTM32InitAES_CTR(CRYDriver *cryp,
+                                 AESContext *ctxp,
+                                 crykey_t key_id,
+                                 const uint8_t *iv);
+  cryerror_t crySTM32InitAES_GCM(CRYDriver *cryp,
+                                 AESContext *ctxp,
+                                 crykey_t key_id,
+                                 bool encrypt,
+                                 const uint8_t *iv);
+  cryerror_t crySTM32AuthAES_GCM(CRYDriver *cryp,
+                                 AESContext *ctxp,
+                                 size_t size,
+                                 const uint8_t *in);
+  cryerror_t crySTM32UpdateAES(CRYDriver *cryp,
+                               AESContext *ctxp,
+                               size_t size,
+                               const uint8_t *in,
+                               uint8_t *out);
+  cryerror_t crySTM32FinalAES(CRYDriver *cryp,
+                              AESContext *ctxp,
+                              size_t tag_size,
+                              uint8_t *tag);
+#endif
+#if (CRY_LLD_SUPPORTS_SHA256 == TRUE) || defined(__DOXYGEN__)
+  void crySTM32ReleaseSHA256(CRYDriver *cryp, SHA256Context *sha256ctxp);
+#endif
+#if STM32_CRY_USE_QUEUE == TRUE
+#if STM32_CRY_USE_CRYP1 == TRUE
+  void crySTM32QueueAESI(CRYDriver *cryp, cry_aes_job_t *jp);
+  void crySTM32QueueAES(CRYDriver *cryp, cry_aes_job_t *jp);
+#endif
+#if STM32_CRY_USE_HASH1 == TRUE
+  void crySTM32QueueSHA256I(CRYDriver *cryp, cry_hash_job_t *jp);
+  void crySTM32QueueSHA256(CRYDriver *cryp, cry_hash_job_t *jp);
+#endif
+#endif
 #ifdef __cplusplus
 }
 #endif
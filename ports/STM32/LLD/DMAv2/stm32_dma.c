@@ -790,6 +790,104 @@ void dmaSetRequestSource(const stm32_dma_stream_t *dmastp, uint32_t per) {
 }
 #endif
 
+#if defined(STM32U5) || defined(__DOXYGEN__) // STM32U5 PORT
+/**
+ * @brief   Initializes a linked-list node.
+ * @details The node is initialized as the last one of a chain, use
+ *          @p dmaLliLink() in order to append further nodes.
+ * @note    The @p ctr2 value must include the request selection of the
+ *          stream the node is meant for, see
+ *          @p dmaStreamGetRequestSource().
+ *
+ * @param[out] lli      pointer to the @p stm32_dma_lli_t node
+ * @param[in] ctr1      value to be loaded in the CTR1 register
+ * @param[in] ctr2      value to be loaded in the CTR2 register
+ * @param[in] src       source address
+ * @param[in] dst       destination address
+ * @param[in] n         block size in bytes
+ *
+ * @special
+ */
+void dmaLliObjectInit(stm32_dma_lli_t *lli, uint32_t ctr1, uint32_t ctr2,
+                      const volatile void *src, volatile void *dst,
+                      size_t n) {
+
+  osalDbgCheck((lli != NULL) && (((uint32_t)lli & 3U) == 0U));
+  osalDbgAssert(n <= STM32_DMA_MAX_TRANSFER, "unsupported DMA transfer size");
+
+  lli->ctr1 = ctr1;
+  lli->ctr2 = ctr2;
+  lli->cbr1 = (uint32_t)n;
+  lli->csar = (uint32_t)src;
+  lli->cdar = (uint32_t)dst;
+  lli->cllr = 0U;
+}
+
+/**
+ * @brief   Links a node to the next one in a chain.
+ * @details Linking the last node of a chain to the first one makes the
+ *          chain circular, a two nodes circular chain is a ping-pong
+ *          buffer.
+ *
+ * @param[in] lli       pointer to the @p stm32_dma_lli_t node
+ * @param[in] next      pointer to the next node or @p NULL if @p lli is
+ *                      the last node of the chain
+ *
+ * @special
+ */
+void dmaLliLink(stm32_dma_lli_t *lli, const stm32_dma_lli_t *next) {
+
+  osalDbgCheck(lli != NULL);
+
+  if (next == NULL) {
+    lli->cllr = 0U;
+    return;
+  }
+
+  osalDbgAssert(((uint32_t)next & 3U) == 0U, "unaligned node");
+  osalDbgAssert(((uint32_t)lli  & DMA_CLBAR_LBA_Msk) ==
+                ((uint32_t)next & DMA_CLBAR_LBA_Msk),
+                "nodes not in the same segment");
+
+  lli->cllr = STM32_DMA_LLI_UPDATE_ALL |
+              ((uint32_t)next & DMA_CLLR_LA_Msk);
+}
+
+/**
+ * @brief   Starts a linked-list transfer.
+ * @details The channel is started with an empty block so the GPDMA loads
+ *          the first node by itself, the whole chain is then executed
+ *          without software intervention.
+ * @pre     The stream must have been allocated using @p dmaStreamAlloc()
+ *          and must be disabled.
+ *
+ * @param[in] dmastp    pointer to a stm32_dma_stream_t structure
+ * @param[in] lli       pointer to the first node of the chain
+ * @param[in] ccr       interrupt enable bits to be set in the CCR register,
+ *                      bits outside @p STM32_DMA_ISR_MASK are ignored
+ *
+ * @iclass
+ */
+void dmaStreamStartLinkedListI(const stm32_dma_stream_t *dmastp,
+                               const stm32_dma_lli_t *lli,
+                               uint32_t ccr) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((dmastp != NULL) && (lli != NULL));
+  osalDbgAssert((dmastp->stream->CCR & DMA_CCR_EN) == 0U, "not disabled");
+  osalDbgAssert(((uint32_t)lli & 3U) == 0U, "unaligned node");
+
+  dmastp->stream->CFCR  = STM32_DMA_ISR_MASK;
+  dmastp->stream->CBR1  = 0U;
+  dmastp->stream->CLBAR = (uint32_t)lli & DMA_CLBAR_LBA_Msk;
+  dmastp->stream->CLLR  = STM32_DMA_LLI_UPDATE_ALL |
+                          ((uint32_t)lli & DMA_CLLR_LA_Msk);
+  dmastp->stream->CCR   = (dmastp->stream->CCR &
+                           ~(STM32_DMA_ISR_MASK | DMA_CCR_LSM)) |
+                          (ccr & STM32_DMA_ISR_MASK) | DMA_CCR_EN;
+}
+#endif
+
 #endif /* STM32_DMA_REQUIRED */
 
 /** @} */
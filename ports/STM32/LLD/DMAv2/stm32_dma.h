@@ -279,6 +279,42 @@
 #define STM32_DMA_ISR_TCIF          DMA_LISR_TCIF0
 /** @} */
 
+#if defined(STM32U5) || defined(__DOXYGEN__) // STM32U5 PORT
+/**
+ * @name    GPDMA linked-list constants
+ * @{
+ */
+/**
+ * @brief   CLLR update mask used by all the nodes built by this driver.
+ * @details CTR1, CTR2, CBR1, CSAR, CDAR and CLLR are reloaded on each link,
+ *          this is the memory layout of @p stm32_dma_lli_t.
+ */
+#define STM32_DMA_LLI_UPDATE_ALL    (DMA_CLLR_UT1 | DMA_CLLR_UT2 |          \
+                                     DMA_CLLR_UB1 | DMA_CLLR_USA |          \
+                                     DMA_CLLR_UDA | DMA_CLLR_ULL)
+
+/**
+ * @brief   Transfer complete event at the end of each block.
+ */
+#define STM32_DMA_CTR2_TCEM_BLOCK   0U
+
+/**
+ * @brief   Transfer complete event at the end of each repeated block.
+ */
+#define STM32_DMA_CTR2_TCEM_RBLOCK  DMA_CTR2_TCEM_0
+
+/**
+ * @brief   Transfer complete event at the end of each linked-list item.
+ */
+#define STM32_DMA_CTR2_TCEM_LLI     DMA_CTR2_TCEM_1
+
+/**
+ * @brief   Transfer complete event at the end of the last linked-list item.
+ */
+#define STM32_DMA_CTR2_TCEM_LAST    (DMA_CTR2_TCEM_0 | DMA_CTR2_TCEM_1)
+/** @} */
+#endif
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -465,6 +501,26 @@ typedef struct {
   uint8_t               vector;         /**< @brief Associated IRQ vector.  */
 } stm32_dma_stream_t;
 
+#if defined(STM32U5) || defined(__DOXYGEN__) // STM32U5 PORT
+/**
+ * @brief   GPDMA linked-list item.
+ * @details Memory image of the channel registers reloaded by the GPDMA when
+ *          it follows a link, the layout matches
+ *          @p STM32_DMA_LLI_UPDATE_ALL.
+ * @note    The GPDMA addresses nodes as a 16 bits offset from the CLBAR
+ *          base, all the nodes of a chain must be word aligned and reside in
+ *          the same 64kB memory segment.
+ */
+typedef struct stm32_dma_lli {
+  volatile uint32_t     ctr1;           /**< @brief CTR1 reload value.      */
+  volatile uint32_t     ctr2;           /**< @brief CTR2 reload value.      */
+  volatile uint32_t     cbr1;           /**< @brief CBR1 reload value.      */
+  volatile uint32_t     csar;           /**< @brief CSAR reload value.      */
+  volatile uint32_t     cdar;           /**< @brief CDAR reload value.      */
+  volatile uint32_t     cllr;           /**< @brief Link to the next node.  */
+} stm32_dma_lli_t;
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -739,6 +795,80 @@ typedef struct {
  */
 #define dmaStreamGetCurrentTarget(dmastp)                                   \
   (((dmastp)->stream->CR >> DMA_SxCR_CT_Pos) & 1U)
+
+#if defined(STM32U5) || defined(__DOXYGEN__) // STM32U5 PORT
+/**
+ * @brief   Returns the request selection bits of a DMA stream.
+ * @details The returned value is meant to be ORed into the @p ctr2 field
+ *          of the linked-list nodes used on the stream, nodes reload the
+ *          whole CTR2 register.
+ *
+ * @param[in] dmastp    pointer to a stm32_dma_stream_t structure
+ * @return              The REQSEL, DREQ and SWREQ bits of CTR2.
+ *
+ * @special
+ */
+#define dmaStreamGetRequestSource(dmastp)                                   \
+  ((dmastp)->stream->CTR2 & (DMA_CTR2_REQSEL_Msk | DMA_CTR2_DREQ |          \
+                             DMA_CTR2_SWREQ))
+
+/**
+ * @brief   Returns the node that will be loaded on the next link.
+ * @note    This function can be invoked in both ISR or thread context.
+ *
+ * @param[in] dmastp    pointer to a stm32_dma_stream_t structure
+ * @return              Pointer to the next @p stm32_dma_lli_t.
+ * @retval NULL         if the current node is the last of the chain.
+ *
+ * @special
+ */
+#define dmaStreamGetNextLink(dmastp)                                        \
+  (((dmastp)->stream->CLLR & DMA_CLLR_LA_Msk) == 0U ? NULL :                \
+   (stm32_dma_lli_t *)(((dmastp)->stream->CLBAR & DMA_CLBAR_LBA_Msk) |      \
+                       ((dmastp)->stream->CLLR & DMA_CLLR_LA_Msk)))
+
+/**
+ * @brief   Changes the source address of a linked-list node.
+ * @note    Only nodes not currently loaded into the channel can be updated,
+ *          in ping-pong chains this is the idle half.
+ *
+ * @param[in] lli       pointer to a @p stm32_dma_lli_t node
+ * @param[in] addr      new source address
+ *
+ * @special
+ */
+#define dmaLliSetSource(lli, addr) {                                        \
+  (lli)->csar = (uint32_t)(addr);                                           \
+}
+
+/**
+ * @brief   Changes the destination address of a linked-list node.
+ * @note    Only nodes not currently loaded into the channel can be updated,
+ *          in ping-pong chains this is the idle half.
+ *
+ * @param[in] lli       pointer to a @p stm32_dma_lli_t node
+ * @param[in] addr      new destination address
+ *
+ * @special
+ */
+#define dmaLliSetDestination(lli, addr) {                                   \
+  (lli)->cdar = (uint32_t)(addr);                                           \
+}
+
+/**
+ * @brief   Changes the size of the block transferred by a linked-list node.
+ * @note    Only nodes not currently loaded into the channel can be updated,
+ *          in ping-pong chains this is the idle half.
+ *
+ * @param[in] lli       pointer to a @p stm32_dma_lli_t node
+ * @param[in] size      block size in bytes
+ *
+ * @special
+ */
+#define dmaLliSetTransactionSize(lli, size) {                               \
+  (lli)->cbr1 = (uint32_t)(size) & DMA_CBR1_BNDT_Msk;                       \
+}
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -766,6 +896,15 @@ extern "C" {
 #if STM32_DMA_SUPPORTS_DMAMUX == TRUE
   void dmaSetRequestSource(const stm32_dma_stream_t *dmastp, uint32_t per);
 #endif
+#if defined(STM32U5) // STM32U5 PORT
+  void dmaLliObjectInit(stm32_dma_lli_t *lli, uint32_t ctr1, uint32_t ctr2,
+                        const volatile void *src, volatile void *dst,
+                        size_t n);
+  void dmaLliLink(stm32_dma_lli_t *lli, const stm32_dma_lli_t *next);
+  void dmaStreamStartLinkedListI(const stm32_dma_stream_t *dmastp,
+                                 const stm32_dma_lli_t *lli,
+                                 uint32_t ccr);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,515 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    OCTOSPIv1/hal_wspi_lld.c
+ * @brief   STM32 OCTOSPI subsystem low level driver source.
+ *
+ * @addtogroup WSPI
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_WSPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define OCTOSPI_CR_FMODE_IWRITE             0U
+#define OCTOSPI_CR_FMODE_IREAD              OCTOSPI_CR_FMODE_0
+#define OCTOSPI_CR_FMODE_MEMMAP             (OCTOSPI_CR_FMODE_0 |           \
+                                             OCTOSPI_CR_FMODE_1)
+
+#define OCTOSPI_FCR_ALL                     (OCTOSPI_FCR_CTEF |             \
+                                             OCTOSPI_FCR_CTCF |             \
+                                             OCTOSPI_FCR_CSMF |             \
+                                             OCTOSPI_FCR_CTOF)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief OCTOSPI1 driver identifier.*/
+#if STM32_WSPI_USE_OCTOSPI1 || defined(__DOXYGEN__)
+WSPIDriver WSPID1;
+#endif
+
+/** @brief OCTOSPI2 driver identifier.*/
+#if STM32_WSPI_USE_OCTOSPI2 || defined(__DOXYGEN__)
+WSPIDriver WSPID2;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Loads the phases of a command.
+ * @details The operation starts on the AR write when an address phase is
+ *          present, else on the IR write, the data length must have been
+ *          programmed before.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] cr        functional mode and interrupt bits to be set in CR
+ *
+ * @notapi
+ */
+static void wspi_lld_load_command(WSPIDriver *wspip,
+                                  const wspi_command_t *cmdp,
+                                  uint32_t cr) {
+  OCTOSPI_TypeDef *ospi = wspip->ospi;
+
+  ospi->CR  = (ospi->CR & ~(OCTOSPI_CR_FMODE | OCTOSPI_CR_TCIE)) | cr;
+  ospi->TCR = (wspip->config->tcr & (STM32_TCR_DHQC | STM32_TCR_SSHIFT)) |
+              (cmdp->dummy & OCTOSPI_TCR_DCYC_Msk);
+  ospi->CCR = cmdp->cfg;
+  ospi->ABR = cmdp->alt;
+  ospi->IR  = cmdp->cmd;
+  if ((cmdp->cfg & WSPI_CFG_ADDR_MODE_MASK) != WSPI_CFG_ADDR_MODE_NONE) {
+    ospi->AR = cmdp->addr;
+  }
+}
+
+/**
+ * @brief   Starts the DMA side of an indirect mode transfer.
+ * @details The buffer is split in linked-list nodes of up to
+ *          @p STM32_DMA_MAX_TRANSFER bytes so the whole transfer is
+ *          executed without software intervention.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] n         number of bytes to be transferred
+ * @param[in] mem       address of the memory buffer
+ * @param[in] receive   @p true if the transfer is from the OCTOSPI
+ *
+ * @notapi
+ */
+static void wspi_lld_start_dma(WSPIDriver *wspip, size_t n,
+                               uint32_t mem, bool receive) {
+  uint32_t ctr2;
+  size_t i;
+
+  ctr2 = (dmaStreamGetRequestSource(wspip->dma) &
+          ~(DMA_CTR2_SWREQ | DMA_CTR2_DREQ)) | STM32_DMA_CTR2_TCEM_LAST;
+  for (i = 0U; n > 0U; i++) {
+    size_t chunk = n < STM32_DMA_MAX_TRANSFER ? n : STM32_DMA_MAX_TRANSFER;
+
+    if (receive) {
+      dmaLliObjectInit(&wspip->lli[i], DMA_CTR1_DINC, ctr2,
+                       &wspip->ospi->DR, (void *)mem, chunk);
+    }
+    else {
+      dmaLliObjectInit(&wspip->lli[i], DMA_CTR1_SINC, ctr2 | DMA_CTR2_DREQ,
+                       (const void *)mem, &wspip->ospi->DR, chunk);
+    }
+    dmaLliLink(&wspip->lli[i], n > chunk ? &wspip->lli[i + 1U] : NULL);
+    mem += chunk;
+    n   -= chunk;
+  }
+
+  /* Only the receive operations complete on the DMA, the FIFO is empty
+     when the last byte has been moved.*/
+  dmaStreamDisable(wspip->dma);
+  dmaStreamStartLinkedListI(wspip->dma, &wspip->lli[0],
+                            (receive ? DMA_CCR_TCIE : 0U) |
+                            DMA_CCR_DTEIE | DMA_CCR_ULEIE | DMA_CCR_USEIE);
+}
+
+/**
+ * @brief   Shared OCTOSPI DMA service routine.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ *
+ * @notapi
+ */
+static void wspi_lld_serve_dma_interrupt(WSPIDriver *wspip, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_WSPI_DMA_ERROR_HOOK)
+  if ((flags & (DMA_CFCR_USEF | DMA_CFCR_ULEF | DMA_CFCR_DTEF)) != 0U) {
+    STM32_WSPI_DMA_ERROR_HOOK(wspip);
+  }
+#endif
+
+  if ((flags & DMA_CFCR_TCF) != 0U) {
+    /* End of a receive operation.*/
+    wspip->ospi->FCR = OCTOSPI_FCR_CTCF;
+    dmaStreamDisable(wspip->dma);
+
+    /* Portable WSPI ISR code defined in the high level driver, note, it is
+       a macro.*/
+    _wspi_isr_code(wspip);
+  }
+}
+
+/**
+ * @brief   Shared OCTOSPI service routine.
+ * @details Completes the command and send operations, the interrupt is
+ *          only enabled for those.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ *
+ * @notapi
+ */
+static void wspi_lld_serve_interrupt(WSPIDriver *wspip) {
+
+  wspip->ospi->FCR = OCTOSPI_FCR_CTCF;
+  wspip->ospi->CR &= ~OCTOSPI_CR_TCIE;
+  dmaStreamDisable(wspip->dma);
+
+  /* Portable WSPI ISR code defined in the high level driver, note, it is
+     a macro.*/
+  _wspi_isr_code(wspip);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+#if STM32_WSPI_USE_OCTOSPI1 || defined(__DOXYGEN__)
+#if !defined(STM32_OCTOSPI1_SUPPRESS_ISR)
+#if !defined(STM32_OCTOSPI1_HANDLER)
+#error "STM32_OCTOSPI1_HANDLER not defined"
+#endif
+/**
+ * @brief   OCTOSPI1 interrupt handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(STM32_OCTOSPI1_HANDLER) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  wspi_lld_serve_interrupt(&WSPID1);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif /* !defined(STM32_OCTOSPI1_SUPPRESS_ISR) */
+#endif /* STM32_WSPI_USE_OCTOSPI1 */
+
+#if STM32_WSPI_USE_OCTOSPI2 || defined(__DOXYGEN__)
+#if !defined(STM32_OCTOSPI2_SUPPRESS_ISR)
+#if !defined(STM32_OCTOSPI2_HANDLER)
+#error "STM32_OCTOSPI2_HANDLER not defined"
+#endif
+/**
+ * @brief   OCTOSPI2 interrupt handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(STM32_OCTOSPI2_HANDLER) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  wspi_lld_serve_interrupt(&WSPID2);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif /* !defined(STM32_OCTOSPI2_SUPPRESS_ISR) */
+#endif /* STM32_WSPI_USE_OCTOSPI2 */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level WSPI driver initialization.
+ *
+ * @notapi
+ */
+void wspi_lld_init(void) {
+
+#if STM32_WSPI_USE_OCTOSPI1
+  wspiObjectInit(&WSPID1);
+  WSPID1.ospi    = OCTOSPI1;
+  WSPID1.membase = (uint8_t *)OCTOSPI1_BASE;
+  WSPID1.dma     = NULL;
+#if !defined(STM32_OCTOSPI1_SUPPRESS_ISR)
+  nvicEnableVector(STM32_OCTOSPI1_NUMBER, STM32_WSPI_OCTOSPI1_IRQ_PRIORITY);
+#endif
+#endif
+
+#if STM32_WSPI_USE_OCTOSPI2
+  wspiObjectInit(&WSPID2);
+  WSPID2.ospi    = OCTOSPI2;
+  WSPID2.membase = (uint8_t *)OCTOSPI2_BASE;
+  WSPID2.dma     = NULL;
+#if !defined(STM32_OCTOSPI2_SUPPRESS_ISR)
+  nvicEnableVector(STM32_OCTOSPI2_NUMBER, STM32_WSPI_OCTOSPI2_IRQ_PRIORITY);
+#endif
+#endif
+}
+
+/**
+ * @brief   Configures and activates the WSPI peripheral.
+ * @note    The OCTOSPI I/O manager is left in its reset configuration,
+ *          port 1 is routed to OCTOSPI1 and port 2 to OCTOSPI2.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ *
+ * @notapi
+ */
+void wspi_lld_start(WSPIDriver *wspip) {
+
+  /* If in stopped state then full initialization.*/
+  if (wspip->state == WSPI_STOP) {
+#if STM32_WSPI_USE_OCTOSPI1
+    if (&WSPID1 == wspip) {
+      wspip->dma = dmaStreamAllocI(STM32_WSPI_OCTOSPI1_DMA_STREAM,
+                                   STM32_WSPI_OCTOSPI1_IRQ_PRIORITY,
+                                   (stm32_dmaisr_t)wspi_lld_serve_dma_interrupt,
+                                   (void *)wspip);
+      osalDbgAssert(wspip->dma != NULL, "unable to allocate stream");
+      rccEnableOCTOSPIM(true);
+      rccEnableOCTOSPI1(true);
+      wspip->dma->stream->CTR2 &= ~DMA_CTR2_REQSEL_Msk ;
+      wspip->dma->stream->CTR2 |= STM32_DMAMUX1_OCTOSPI1 ;
+    }
+#endif
+#if STM32_WSPI_USE_OCTOSPI2
+    if (&WSPID2 == wspip) {
+      wspip->dma = dmaStreamAllocI(STM32_WSPI_OCTOSPI2_DMA_STREAM,
+                                   STM32_WSPI_OCTOSPI2_IRQ_PRIORITY,
+                                   (stm32_dmaisr_t)wspi_lld_serve_dma_interrupt,
+                                   (void *)wspip);
+      osalDbgAssert(wspip->dma != NULL, "unable to allocate stream");
+      rccEnableOCTOSPIM(true);
+      rccEnableOCTOSPI2(true);
+      wspip->dma->stream->CTR2 &= ~DMA_CTR2_REQSEL_Msk ;
+      wspip->dma->stream->CTR2 |= STM32_DMAMUX1_OCTOSPI2 ;
+    }
+#endif
+  }
+
+  /* Common initializations, the FIFO threshold is one byte for the DMA.*/
+  wspip->ospi->CR   = 0U;
+  wspip->ospi->DCR1 = wspip->config->dcr1;
+  wspip->ospi->DCR2 = wspip->config->dcr2;
+  wspip->ospi->DCR3 = wspip->config->dcr3;
+  wspip->ospi->DCR4 = wspip->config->dcr4;
+  wspip->ospi->LPTR = wspip->config->lptr;
+  wspip->ospi->FCR  = OCTOSPI_FCR_ALL;
+  wspip->ospi->CR   = OCTOSPI_CR_DMAEN | OCTOSPI_CR_EN;
+}
+
+/**
+ * @brief   Deactivates the WSPI peripheral.
+ * @note    The OCTOSPI I/O manager clock is shared and left enabled.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ *
+ * @notapi
+ */
+void wspi_lld_stop(WSPIDriver *wspip) {
+
+  /* If in ready state then disables the OCTOSPI clock.*/
+  if (wspip->state == WSPI_READY) {
+
+    /* OCTOSPI disable.*/
+    wspip->ospi->CR = 0U;
+
+    /* Releasing the DMA.*/
+    dmaStreamFreeI(wspip->dma);
+    wspip->dma = NULL;
+
+    /* Stopping involved clocks.*/
+#if STM32_WSPI_USE_OCTOSPI1
+    if (&WSPID1 == wspip) {
+      rccDisableOCTOSPI1();
+    }
+#endif
+#if STM32_WSPI_USE_OCTOSPI2
+    if (&WSPID2 == wspip) {
+      rccDisableOCTOSPI2();
+    }
+#endif
+  }
+}
+
+/**
+ * @brief   Sends a command without data phase.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ *
+ * @notapi
+ */
+void wspi_lld_command(WSPIDriver *wspip, const wspi_command_t *cmdp) {
+
+  wspip->ospi->FCR = OCTOSPI_FCR_CTCF;
+  wspi_lld_load_command(wspip, cmdp,
+                        OCTOSPI_CR_FMODE_IWRITE | OCTOSPI_CR_TCIE);
+}
+
+/**
+ * @brief   Sends a command with data over the WSPI bus.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ *
+ * @notapi
+ */
+void wspi_lld_send(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                   size_t n, const uint8_t *txbuf) {
+
+  osalDbgAssert(n <= (size_t)STM32_WSPI_DMA_NODES * STM32_DMA_MAX_TRANSFER,
+                "transfer too large");
+
+  wspip->ospi->FCR = OCTOSPI_FCR_CTCF;
+  wspip->ospi->DLR = (uint32_t)n - 1U;
+  wspi_lld_load_command(wspip, cmdp,
+                        OCTOSPI_CR_FMODE_IWRITE | OCTOSPI_CR_TCIE);
+  wspi_lld_start_dma(wspip, n, (uint32_t)txbuf, false);
+}
+
+/**
+ * @brief   Sends a command then receives data over the WSPI bus.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to receive
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                      size_t n, uint8_t *rxbuf) {
+
+  osalDbgAssert(n <= (size_t)STM32_WSPI_DMA_NODES * STM32_DMA_MAX_TRANSFER,
+                "transfer too large");
+
+  wspip->ospi->FCR = OCTOSPI_FCR_CTCF;
+  wspip->ospi->DLR = (uint32_t)n - 1U;
+  wspi_lld_load_command(wspip, cmdp, OCTOSPI_CR_FMODE_IREAD);
+  wspi_lld_start_dma(wspip, n, (uint32_t)rxbuf, true);
+}
+
+#if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Maps in memory space a WSPI flash device.
+ * @pre     The memory flash device must be initialized appropriately
+ *          before mapping it in memory space.
+ * @note    The command must have an address phase, it is used for all the
+ *          read accesses to the mapped window.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[out] addrp    pointer to the memory start address of the mapped
+ *                      flash or @p NULL
+ *
+ * @notapi
+ */
+void wspi_lld_map_flash(WSPIDriver *wspip,
+                        const wspi_command_t *cmdp,
+                        uint8_t **addrp) {
+  uint32_t cr;
+
+  osalDbgAssert((cmdp->cfg & WSPI_CFG_ADDR_MODE_MASK) !=
+                WSPI_CFG_ADDR_MODE_NONE, "address phase required");
+
+  STM32_WSPI_OTFDEC_MAP_HOOK(wspip);
+
+  /* The read command is loaded while still in indirect mode, without an
+     AR write nothing is started.*/
+  wspip->ospi->TCR = (wspip->config->tcr & (STM32_TCR_DHQC |
+                                            STM32_TCR_SSHIFT)) |
+                     (cmdp->dummy & OCTOSPI_TCR_DCYC_Msk);
+  wspip->ospi->CCR = cmdp->cfg;
+  wspip->ospi->ABR = cmdp->alt;
+  wspip->ospi->IR  = cmdp->cmd;
+
+  /* Starting memory-mapped mode, the timeout counter releases nCS and
+     drops the prefetched data after LPTR idle cycles.*/
+  cr = wspip->ospi->CR & ~(OCTOSPI_CR_FMODE | OCTOSPI_CR_TCEN |
+                           OCTOSPI_CR_TCIE);
+  if (wspip->config->lptr != 0U) {
+    cr |= OCTOSPI_CR_TCEN;
+  }
+  wspip->ospi->CR = cr | OCTOSPI_CR_FMODE_MEMMAP;
+
+  /* Mapped flash absolute base address.*/
+  if (addrp != NULL) {
+    *addrp = wspip->membase;
+  }
+}
+
+/**
+ * @brief   Unmaps from memory space a WSPI flash device.
+ * @post    The memory flash device must be re-initialized for normal
+ *          commands exchange.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ *
+ * @notapi
+ */
+void wspi_lld_unmap_flash(WSPIDriver *wspip) {
+
+  /* Aborting memory mapped mode, a pending prefetch is dropped.*/
+  wspip->ospi->CR |= OCTOSPI_CR_ABORT;
+  while ((wspip->ospi->CR & OCTOSPI_CR_ABORT) != 0U) {
+  }
+
+  /* Going back to indirect mode.*/
+  wspip->ospi->FCR = OCTOSPI_FCR_ALL;
+  wspip->ospi->CR &= ~(OCTOSPI_CR_FMODE | OCTOSPI_CR_TCEN);
+
+  STM32_WSPI_OTFDEC_UNMAP_HOOK(wspip);
+}
+
+/**
+ * @brief   Sets the command used by the memory-mapped mode writes.
+ * @details RAM devices, PSRAM or HyperRAM, can be written through the
+ *          mapped window once a write command has been programmed, the
+ *          setting is retained by the OCTOSPI until it is changed.
+ * @pre     The driver must be in the @p WSPI_READY state.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the write command descriptor
+ *
+ * @api
+ */
+void wspiSTM32SetWriteCommand(WSPIDriver *wspip,
+                              const wspi_command_t *cmdp) {
+
+  osalDbgCheck((wspip != NULL) && (cmdp != NULL));
+
+  osalSysLock();
+  osalDbgAssert(wspip->state == WSPI_READY, "not ready");
+
+  /* Same layout as CCR except for SIOO which has no meaning on writes.*/
+  wspip->ospi->WTCR = cmdp->dummy & OCTOSPI_WTCR_DCYC_Msk;
+  wspip->ospi->WCCR = cmdp->cfg & ~WSPI_CFG_SIOO;
+  wspip->ospi->WABR = cmdp->alt;
+  wspip->ospi->WIR  = cmdp->cmd;
+  osalSysUnlock();
+}
+#endif /* WSPI_SUPPORTS_MEMMAP == TRUE */
+
+#endif /* HAL_USE_WSPI */
+
+/** @} */
@@ -0,0 +1,317 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    OCTOSPIv1/hal_wspi_lld.h
+ * @brief   STM32 OCTOSPI subsystem low level driver header.
+ *
+ * @addtogroup WSPI
+ * @{
+ */
+
+#ifndef HAL_WSPI_LLD_H
+#define HAL_WSPI_LLD_H
+
+#if (HAL_USE_WSPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    WSPI implementation capabilities
+ * @{
+ */
+#define WSPI_SUPPORTS_MEMMAP                TRUE
+#define WSPI_DEFAULT_CFG_MASKS              TRUE
+/** @} */
+
+/**
+ * @name    DCR1 register options
+ * @{
+ */
+#define STM32_DCR1_CK_MODE                  (1U << 0U)
+#define STM32_DCR1_FRCK_MODE                (1U << 1U)
+#define STM32_DCR1_DLYBYP                   (1U << 3U)
+#define STM32_DCR1_CS_HT_MASK               (7U << 8U)
+#define STM32_DCR1_CS_HT(n)                 ((n) << 8U)
+#define STM32_DCR1_DEVICE_SIZE_MASK         (31U << 16U)
+#define STM32_DCR1_DEVICE_SIZE(n)           ((n) << 16U)
+#define STM32_DCR1_MTYP_MASK                (7U << 24U)
+#define STM32_DCR1_MTYP(n)                  ((n) << 24U)
+#define STM32_DCR1_MTYP_MICRON              STM32_DCR1_MTYP(0U)
+#define STM32_DCR1_MTYP_MACRONIX            STM32_DCR1_MTYP(1U)
+#define STM32_DCR1_MTYP_STANDARD            STM32_DCR1_MTYP(2U)
+#define STM32_DCR1_MTYP_MACRONIX_RAM        STM32_DCR1_MTYP(3U)
+#define STM32_DCR1_MTYP_HYPERBUS_MEM        STM32_DCR1_MTYP(4U)
+#define STM32_DCR1_MTYP_HYPERBUS_REG        STM32_DCR1_MTYP(5U)
+/** @} */
+
+/**
+ * @name    DCR2 register options
+ * @{
+ */
+#define STM32_DCR2_PRESCALER_MASK           (255U << 0U)
+#define STM32_DCR2_PRESCALER(n)             ((n) << 0U)
+#define STM32_DCR2_WRAPSIZE_MASK            (7U << 16U)
+#define STM32_DCR2_WRAPSIZE(n)              ((n) << 16U)
+/** @} */
+
+/**
+ * @name    DCR3 register options
+ * @{
+ */
+#define STM32_DCR3_MAXTRAN_MASK             (255U << 0U)
+#define STM32_DCR3_MAXTRAN(n)               ((n) << 0U)
+#define STM32_DCR3_CSBOUND_MASK             (31U << 16U)
+#define STM32_DCR3_CSBOUND(n)               ((n) << 16U)
+/** @} */
+
+/**
+ * @name    DCR4 register options
+ * @{
+ */
+#define STM32_DCR4_REFRESH_MASK             (0xFFFFFFFFU << 0U)
+#define STM32_DCR4_REFRESH(n)               ((n) << 0U)
+/** @} */
+
+/**
+ * @name    TCR register options
+ * @note    The dummy cycles field is taken from the command descriptor.
+ * @{
+ */
+#define STM32_TCR_DHQC                      (1U << 28U)
+#define STM32_TCR_SSHIFT                    (1U << 30U)
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   WSPID1 driver enable switch.
+ * @details If set to @p TRUE the support for OCTOSPI1 is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_WSPI_USE_OCTOSPI1) || defined(__DOXYGEN__)
+#define STM32_WSPI_USE_OCTOSPI1             FALSE
+#endif
+
+/**
+ * @brief   WSPID2 driver enable switch.
+ * @details If set to @p TRUE the support for OCTOSPI2 is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_WSPI_USE_OCTOSPI2) || defined(__DOXYGEN__)
+#define STM32_WSPI_USE_OCTOSPI2             FALSE
+#endif
+
+/**
+ * @brief   OCTOSPI1 interrupt priority level setting.
+ */
+#if !defined(STM32_WSPI_OCTOSPI1_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_WSPI_OCTOSPI1_IRQ_PRIORITY    10
+#endif
+
+/**
+ * @brief   OCTOSPI2 interrupt priority level setting.
+ */
+#if !defined(STM32_WSPI_OCTOSPI2_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_WSPI_OCTOSPI2_IRQ_PRIORITY    10
+#endif
+
+/**
+ * @brief   OCTOSPI1 DMA stream.
+ */
+#if !defined(STM32_WSPI_OCTOSPI1_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_WSPI_OCTOSPI1_DMA_STREAM      STM32_DMA_STREAM_ID_ANY
+#endif
+
+/**
+ * @brief   OCTOSPI2 DMA stream.
+ */
+#if !defined(STM32_WSPI_OCTOSPI2_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_WSPI_OCTOSPI2_DMA_STREAM      STM32_DMA_STREAM_ID_ANY
+#endif
+
+/**
+ * @brief   Number of DMA linked-list nodes per driver.
+ * @details Each node moves up to @p STM32_DMA_MAX_TRANSFER bytes, this
+ *          setting limits the size of a single indirect mode transfer.
+ */
+#if !defined(STM32_WSPI_DMA_NODES) || defined(__DOXYGEN__)
+#define STM32_WSPI_DMA_NODES                4
+#endif
+
+/**
+ * @brief   WSPI DMA error hook.
+ */
+#if !defined(STM32_WSPI_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_WSPI_DMA_ERROR_HOOK(wspip)    osalSysHalt("DMA failure")
+#endif
+
+/**
+ * @brief   OTFDEC hook invoked before entering memory-mapped mode.
+ * @details The OTFDEC regions decrypting the mapped window, OTFDEC1 for
+ *          OCTOSPI1 and OTFDEC2 for OCTOSPI2, can be programmed here, the
+ *          OCTOSPI is idle while the hook runs.
+ */
+#if !defined(STM32_WSPI_OTFDEC_MAP_HOOK) || defined(__DOXYGEN__)
+#define STM32_WSPI_OTFDEC_MAP_HOOK(wspip)
+#endif
+
+/**
+ * @brief   OTFDEC hook invoked after leaving memory-mapped mode.
+ */
+#if !defined(STM32_WSPI_OTFDEC_UNMAP_HOOK) || defined(__DOXYGEN__)
+#define STM32_WSPI_OTFDEC_UNMAP_HOOK(wspip)
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(STM32U5) // STM32U5 PORT
+#error "OCTOSPIv1 requires the STM32U5 GPDMA"
+#endif
+
+#if STM32_WSPI_USE_OCTOSPI1 && !STM32_HAS_OCTOSPI1
+#error "OCTOSPI1 not present in the selected device"
+#endif
+
+#if STM32_WSPI_USE_OCTOSPI2 && !STM32_HAS_OCTOSPI2
+#error "OCTOSPI2 not present in the selected device"
+#endif
+
+#if !STM32_WSPI_USE_OCTOSPI1 && !STM32_WSPI_USE_OCTOSPI2
+#error "WSPI driver activated but no OCTOSPI peripheral assigned"
+#endif
+
+#if STM32_WSPI_USE_OCTOSPI1 &&                                              \
+    !OSAL_IRQ_IS_VALID_PRIORITY(STM32_WSPI_OCTOSPI1_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to OCTOSPI1"
+#endif
+
+#if STM32_WSPI_USE_OCTOSPI2 &&                                              \
+    !OSAL_IRQ_IS_VALID_PRIORITY(STM32_WSPI_OCTOSPI2_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to OCTOSPI2"
+#endif
+
+#if STM32_WSPI_USE_OCTOSPI1 &&                                              \
+    !STM32_DMA_IS_VALID_STREAM(STM32_WSPI_OCTOSPI1_DMA_STREAM)
+#error "Invalid DMA stream assigned to OCTOSPI1"
+#endif
+
+#if STM32_WSPI_USE_OCTOSPI2 &&                                              \
+    !STM32_DMA_IS_VALID_STREAM(STM32_WSPI_OCTOSPI2_DMA_STREAM)
+#error "Invalid DMA stream assigned to OCTOSPI2"
+#endif
+
+#if (STM32_WSPI_DMA_NODES < 1) || (STM32_WSPI_DMA_NODES > 64)
+#error "invalid STM32_WSPI_DMA_NODES value"
+#endif
+
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the WSPI driver structure.
+ */
+#define wspi_lld_driver_fields                                              \
+  /* Pointer to the OCTOSPIx registers block.*/                             \
+  OCTOSPI_TypeDef           *ospi;                                          \
+  /* Base of the memory-mapped window.*/                                    \
+  uint8_t                   *membase;                                       \
+  /* OCTOSPI DMA stream.*/                                                  \
+  const stm32_dma_stream_t  *dma;                                           \
+  /* DMA linked-list nodes of the current indirect transfer.*/              \
+  stm32_dma_lli_t           lli[STM32_WSPI_DMA_NODES]
+
+/**
+ * @brief   Low level fields of the WSPI configuration structure.
+ * @note    In memory-mapped mode the prefetch is tuned by the
+ *          @p STM32_DCR2_WRAPSIZE(), @p STM32_DCR3_MAXTRAN() and
+ *          @p STM32_DCR3_CSBOUND() fields.
+ */
+#define wspi_lld_config_fields                                              \
+  /* DCR1 register initialization data.*/                                   \
+  uint32_t                  dcr1;                                           \
+  /* DCR2 register initialization data.*/                                   \
+  uint32_t                  dcr2;                                           \
+  /* DCR3 register initialization data.*/                                   \
+  uint32_t                  dcr3;                                           \
+  /* DCR4 register initialization data.*/                                   \
+  uint32_t                  dcr4;                                           \
+  /* TCR register base value, only DHQC and SSHIFT are used.*/              \
+  uint32_t                  tcr;                                            \
+  /* Memory-mapped mode idle timeout in clock cycles, the prefetched data   \
+     is dropped and nCS released when it expires, zero disables it.*/       \
+  uint32_t                  lptr
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (STM32_WSPI_USE_OCTOSPI1 == TRUE) && !defined(__DOXYGEN__)
+extern WSPIDriver WSPID1;
+#endif
+
+#if (STM32_WSPI_USE_OCTOSPI2 == TRUE) && !defined(__DOXYGEN__)
+extern WSPIDriver WSPID2;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void wspi_lld_init(void);
+  void wspi_lld_start(WSPIDriver *wspip);
+  void wspi_lld_stop(WSPIDriver *wspip);
+  void wspi_lld_command(WSPIDriver *wspip, const wspi_command_t *cmdp);
+  void wspi_lld_send(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                     size_t n, const uint8_t *txbuf);
+  void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                        size_t n, uint8_t *rxbuf);
+#if WSPI_SUPPORTS_MEMMAP == TRUE
+  void wspi_lld_map_flash(WSPIDriver *wspip,
+                          const wspi_command_t *cmdp,
+                          uint8_t **addrp);
+  void wspi_lld_unmap_flash(WSPIDriver *wspip);
+  void wspiSTM32SetWriteCommand(WSPIDriver *wspip,
+                                const wspi_command_t *cmdp);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_WSPI */
+
+#endif /* HAL_WSPI_LLD_H */
+
+/** @} */
@@ -38,6 +38,15 @@
 #define EP0_MAX_INSIZE          64
 #define EP0_MAX_OUTSIZE         64
 
+/* Buffer DMA mode, INCR4 bursts on the AHB.*/
+#define GAHBCFG_DMA_INIT        (GAHBCFG_DMAEN | GAHBCFG_HBSTLEN(3))
+
+#if STM32_USB_OTG2_USE_DMA
+#define otg_dma_mode(usbp)      ((usbp)->otgparams->use_dma)
+#else
+#define otg_dma_mode(usbp)      false
+#endif
+
 #if STM32_OTG_STEPPING == 1
 #if defined(BOARD_OTG_NOVBUSSENS)
 #define GCCFG_INIT_VALUE        (GCCFG_NOVBUSSENS | GCCFG_VBUSASEN |        \
@@ -95,6 +104,37 @@ static union {
  */
 static uint8_t ep0setup_buffer[8];
 
+#if STM32_USB_OTG2_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   DMA area for the EP0 setup packets.
+ * @details Room for the three back-to-back setup packets allowed by
+ *          @p DOEPTSIZ_STUPCNT(3).
+ */
+static uint32_t ep0setup_dma[6];
+
+/**
+ * @brief   DMA bounce buffers.
+ * @details Used for unaligned buffers and for OUT transactions that would
+ *          overflow the application buffer.
+ */
+static struct {
+  /**
+   * @brief   IN endpoints bounce buffers.
+   */
+  uint32_t              in[USB_MAX_ENDPOINTS + 1]
+                          [STM32_USB_OTG2_DMA_BOUNCE_SIZE / 4];
+  /**
+   * @brief   OUT endpoints bounce buffers.
+   */
+  uint32_t              out[USB_MAX_ENDPOINTS + 1]
+                           [STM32_USB_OTG2_DMA_BOUNCE_SIZE / 4];
+  /**
+   * @brief   Mask of the OUT endpoints receiving in their bounce buffer.
+   */
+  uint32_t              out_active;
+} otg_bounce;
+#endif
+
 /**
  * @brief   EP0 initialization structure.
  */
@@ -115,7 +155,8 @@ static const USBEndpointConfig ep0config = {
 static const stm32_otg_params_t fsparams = {
   STM32_USB_OTG1_RX_FIFO_SIZE / 4,
   STM32_OTG1_FIFO_MEM_SIZE,
-  STM32_OTG1_ENDPOINTS
+  STM32_OTG1_ENDPOINTS,
+  false
 };
 #endif
 
@@ -123,7 +164,8 @@ static const stm32_otg_params_t fsparams = {
 static const stm32_otg_params_t hsparams = {
   STM32_USB_OTG2_RX_FIFO_SIZE / 4,
   STM32_OTG2_FIFO_MEM_SIZE,
-  STM32_OTG2_ENDPOINTS
+  STM32_OTG2_ENDPOINTS,
+  STM32_USB_OTG2_USE_DMA
 };
 #endif
 
@@ -191,6 +233,22 @@ static void otg_txfifo_flush(USBDriver *usbp, uint32_t fifo) {
   osalSysPolledDelayX(18);
 }
 
+/**
+ * @brief   Releases the TX FIFO of an IN endpoint.
+ * @details The released block merges with the adjacent free space, the
+ *          free space is the set of gaps between the allocated blocks.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+static void otg_ram_free(USBDriver *usbp, usbep_t ep) {
+
+  usbp->txfifo[ep].start = 0U;
+  usbp->txfifo[ep].size  = 0U;
+}
+
 /**
  * @brief   Resets the FIFO RAM memory allocator.
  *
@@ -199,30 +257,419 @@ static void otg_txfifo_flush(USBDriver *usbp, uint32_t fifo) {
  * @notapi
  */
 static void otg_ram_reset(USBDriver *usbp) {
+  usbep_t ep;
+
+  for (ep = 0; ep <= usbp->otgparams->num_endpoints; ep++) {
+    otg_ram_free(usbp, ep);
+  }
+}
+
+/**
+ * @brief   Finds the first gap able to contain a block in the FIFO RAM.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] size      size of the block in words
+ * @return              The start address in words, or zero if the FIFO RAM
+ *                      cannot contain the block.
+ *
+ * @notapi
+ */
+static uint32_t otg_ram_find(USBDriver *usbp, uint32_t size) {
+  uint32_t start = usbp->otgparams->rx_fifo_size;
+  usbep_t ep;
+
+  /* The candidate position is moved past any overlapping block until it
+     lands in a gap, the first fitting gap is taken.*/
+  ep = 0;
+  while (ep <= usbp->otgparams->num_endpoints) {
+    const stm32_otg_txfifo_t *fp = &usbp->txfifo[ep];
+
+    if ((fp->size > 0U) &&
+        (start < (uint32_t)fp->start + fp->size) &&
+        (fp->start < start + size)) {
+      start = (uint32_t)fp->start + fp->size;
+      ep = 0;
+      continue;
+    }
+    ep++;
+  }
 
-  usbp->pmnext = usbp->otgparams->rx_fifo_size;
+  if (start + size > usbp->otgparams->otg_ram_size) {
+    return 0U;
+  }
+  return start;
 }
 
 /**
- * @brief   Allocates a block from the FIFO RAM memory.
+ * @brief   Allocates the TX FIFO of an IN endpoint.
+ * @details A previous allocation of the same endpoint is released first,
+ *          this allows endpoints to be reconfigured, for example on an
+ *          alternate setting change, without resetting the whole RAM.
  *
  * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
  * @param[in] size      size of the packet buffer to allocate in words
+ * @return              The start address in words.
  *
  * @notapi
  */
-static uint32_t otg_ram_alloc(USBDriver *usbp, size_t size) {
-  uint32_t next;
-
-  next = usbp->pmnext;
-  usbp->pmnext += size;
-  osalDbgAssert(usbp->pmnext <= usbp->otgparams->otg_ram_size,
-                "OTG FIFO memory overflow");
-  return next;
+static uint32_t otg_ram_alloc(USBDriver *usbp, usbep_t ep, size_t size) {
+  uint32_t start;
+
+  otg_ram_free(usbp, ep);
+  start = otg_ram_find(usbp, size);
+  osalDbgAssert(start != 0U, "OTG FIFO memory overflow");
+
+  usbp->txfifo[ep].start = (uint16_t)start;
+  usbp->txfifo[ep].size  = (uint16_t)size;
+  return start;
+}
+
+/**
+ * @brief   Size of the TX FIFO of an IN endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The size in words.
+ *
+ * @notapi
+ */
+static uint32_t otg_txfifo_size(USBDriver *usbp, usbep_t ep) {
+  const USBEndpointConfig *epcp = usbp->epc[ep];
+  uint32_t fsize = epcp->in_maxsize / 4;
+
+  if (epcp->in_multiplier > 1) {
+    return fsize * epcp->in_multiplier;
+  }
+
+#if STM32_USB_OTG_TXFIFO_DOUBLE_BUFFER
+  /* Double buffering of the streaming endpoints, only if it fits, the
+     allocation of the endpoint itself is released first.*/
+  switch (epcp->ep_mode & USB_EP_MODE_TYPE) {
+  case USB_EP_MODE_TYPE_BULK:
+  case USB_EP_MODE_TYPE_ISOC:
+    otg_ram_free(usbp, ep);
+    if (otg_ram_find(usbp, fsize * 2U) != 0U) {
+      return fsize * 2U;
+    }
+    break;
+  default:
+    break;
+  }
+#endif
+
+  return fsize;
+}
+
+#if (STM32_USB_USE_OUT_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Arms a streaming OUT endpoint on the next free buffer.
+ * @note    Nothing is done if a transaction is already armed or if all the
+ *          buffers are waiting to be released.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+static void otg_stream_arm(USBDriver *usbp, usbep_t ep) {
+  USBOutStream *sp = usbp->ostream[ep];
+  USBOutEndpointState *osp = usbp->epc[ep]->out_state;
+
+  if (((usbp->otg->oe[ep].DOEPCTL & DOEPCTL_EPENA) != 0U) ||
+      (sp->count >= sp->nbufs)) {
+    return;
+  }
+
+  osp->rxbuf  = sp->bufs[sp->head];
+  osp->rxsize = sp->bufsize;
+  osp->rxcnt  = 0;
+  usb_lld_start_out(usbp, ep);
+}
+
+/**
+ * @brief   Streaming OUT endpoint transfer complete.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+static void otg_stream_serve_out(USBDriver *usbp, usbep_t ep) {
+  USBOutStream *sp = usbp->ostream[ep];
+
+  sp->lengths[sp->head] = usbp->epc[ep]->out_state->rxcnt;
+  sp->head = (sp->head + 1U) % sp->nbufs;
+  sp->count++;
+
+  /* The endpoint is primed again before notifying.*/
+  osalSysLockFromISR();
+  otg_stream_arm(usbp, ep);
+  osalSysUnlockFromISR();
+
+  sp->cb(usbp, ep, sp->tail, sp->count);
+}
+#endif
+
+#if (STM32_USB_USE_ISO_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Arms an isochronous stream for the next frame.
+ * @details The even/odd frame is selected from DSTS by
+ *          @p usb_lld_start_in() and @p usb_lld_start_out().
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] sp        pointer to the isochronous stream
+ * @return              The endpoint is armed.
+ *
+ * @notapi
+ */
+static bool otg_iso_arm(USBDriver *usbp, USBIsoStream *sp) {
+  usbep_t ep = sp->ep;
+
+  if (sp->in) {
+    USBInEndpointState *isp = usbp->epc[ep]->in_state;
+
+    if ((usbp->otg->ie[ep].DIEPCTL & DIEPCTL_EPENA) != 0U) {
+      return true;
+    }
+    if (sp->count == 0U) {
+      return false;
+    }
+    osalDbgAssert(sp->lengths[sp->head] <= usbp->epc[ep]->in_maxsize,
+                  "frame larger than a packet");
+    isp->txbuf  = sp->bufs[sp->head];
+    isp->txsize = sp->lengths[sp->head];
+    isp->txcnt  = 0;
+    usb_lld_start_in(usbp, ep);
+  }
+  else {
+    USBOutEndpointState *osp = usbp->epc[ep]->out_state;
+
+    if ((usbp->otg->oe[ep].DOEPCTL & DOEPCTL_EPENA) != 0U) {
+      return true;
+    }
+    if (sp->count >= sp->nbufs) {
+      return false;
+    }
+    osp->rxbuf  = sp->bufs[sp->head];
+    osp->rxsize = usbp->epc[ep]->out_maxsize;
+    osp->rxcnt  = 0;
+    usb_lld_start_out(usbp, ep);
+  }
+  return true;
+}
+
+/**
+ * @brief   Isochronous stream transfer complete.
+ * @details The frame buffer is retired and the next one armed immediately
+ *          for the following frame.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] sp        pointer to the isochronous stream
+ *
+ * @notapi
+ */
+static void otg_iso_serve_xfrc(USBDriver *usbp, USBIsoStream *sp) {
+
+  if (sp->in) {
+    sp->count--;
+  }
+  else {
+    if (sp->stopping) {
+      /* Last armed transaction of a stopped stream, discarded.*/
+      usbp->isoout[sp->ep] = NULL;
+      usbp->receiving     &= ~(uint16_t)(1U << sp->ep);
+      return;
+    }
+    sp->lengths[sp->head] = usbp->epc[sp->ep]->out_state->rxcnt;
+    sp->count++;
+  }
+  sp->head = (sp->head + 1U) % sp->nbufs;
+  sp->frames++;
+
+  osalSysLockFromISR();
+  (void)otg_iso_arm(usbp, sp);
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Isochronous streams SOF handling.
+ * @details Streams left idle are armed again, a stream that cannot be
+ *          armed counts an underrun or an overrun, then the application
+ *          is called back.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+static void otg_iso_serve_sof(USBDriver *usbp) {
+  usbep_t ep;
+
+  for (ep = 1; ep <= usbp->otgparams->num_endpoints; ep++) {
+    USBIsoStream *sp;
+    bool armed;
+
+    sp = usbp->isoin[ep];
+    if (sp != NULL) {
+      osalSysLockFromISR();
+      armed = otg_iso_arm(usbp, sp);
+      osalSysUnlockFromISR();
+      if (!armed) {
+        sp->underruns++;
+      }
+      sp->cb(usbp, ep, (sp->head + sp->count) % sp->nbufs,
+             sp->nbufs - sp->count);
+    }
+
+    sp = usbp->isoout[ep];
+    if ((sp != NULL) && !sp->stopping) {
+      osalSysLockFromISR();
+      armed = otg_iso_arm(usbp, sp);
+      osalSysUnlockFromISR();
+      if (!armed) {
+        sp->overruns++;
+      }
+      sp->cb(usbp, ep, (sp->head + sp->nbufs - sp->count) % sp->nbufs,
+             sp->count);
+    }
+  }
+}
+#endif
+
+/**
+ * @brief   Size of an OUT transaction as programmed in DOEPTSIZ.
+ * @details Transaction size is rounded to a multiple of packet size because
+ *          the following requirement in the RM:
+ *          "For OUT transfers, the transfer size field in the endpoint's
+ *          transfer size register must be a multiple of the maximum packet
+ *          size of the endpoint, adjusted to the Word boundary".
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @param[out] pcntp    number of packets in the transaction
+ * @return              The transfer size in bytes.
+ *
+ * @notapi
+ */
+static uint32_t otg_out_xfrsize(USBDriver *usbp, usbep_t ep, uint32_t *pcntp) {
+  uint32_t pcnt;
+
+  pcnt = (usbp->epc[ep]->out_state->rxsize + usbp->epc[ep]->out_maxsize - 1U) /
+         usbp->epc[ep]->out_maxsize;
+  if (pcntp != NULL) {
+    *pcntp = pcnt;
+  }
+  return (pcnt * usbp->epc[ep]->out_maxsize + 3U) & 0xFFFFFFFCU;
+}
+
+#if STM32_USB_OTG2_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Arms EP0 for the reception of setup packets in DMA mode.
+ * @details In buffer DMA mode setup packets are only written to memory
+ *          while the endpoint is enabled, EP0 is re-enabled with the setup
+ *          area as target each time no OUT transaction is pending on it.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+static void otg_ep0_dma_setup(USBDriver *usbp) {
+  stm32_otg_t *otgp = usbp->otg;
+
+  if ((otgp->oe[0].DOEPCTL & DOEPCTL_EPENA) != 0U) {
+    return;
+  }
+
+  otgp->oe[0].DOEPTSIZ = DOEPTSIZ_STUPCNT(3) | DOEPTSIZ_PKTCNT(1) |
+                         DOEPTSIZ_XFRSIZ(sizeof (ep0setup_dma));
+  otgp->oe[0].DOEPDMA  = (uint32_t)ep0setup_dma;
+  otgp->oe[0].DOEPCTL |= DOEPCTL_EPENA | DOEPCTL_USBAEP;
+}
+
+/**
+ * @brief   Largest transaction fitting a bounce buffer.
+ *
+ * @param[in] maxsize   endpoint packet size
+ * @return              The transaction size, a multiple of the packet size.
+ *
+ * @notapi
+ */
+static size_t otg_bounce_size(size_t maxsize) {
+  size_t n = STM32_USB_OTG2_DMA_BOUNCE_SIZE -
+             (STM32_USB_OTG2_DMA_BOUNCE_SIZE % maxsize);
+
+  osalDbgAssert(n > 0U, "bounce buffer smaller than a packet");
+
+  return n;
+}
+
+/**
+ * @brief   Decides the target of an OUT transaction in DMA mode.
+ * @details Aligned buffers receive whole packets directly, a trailing
+ *          partial packet is received in the bounce buffer by a following
+ *          transaction. Unaligned buffers always use the bounce buffer.
+ * @note    The transaction size is reduced accordingly.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The transaction uses the bounce buffer.
+ *
+ * @notapi
+ */
+static bool otg_dma_out_bounce(USBDriver *usbp, usbep_t ep) {
+  USBOutEndpointState *osp = usbp->epc[ep]->out_state;
+  size_t maxsize = usbp->epc[ep]->out_maxsize;
+  size_t n;
+
+  if (((uint32_t)osp->rxbuf & 3U) == 0U) {
+    n = osp->rxsize - (osp->rxsize % maxsize);
+    if ((n > 0U) && ((n & 3U) == 0U)) {
+      osp->rxsize = n;
+      return false;
+    }
+  }
+
+  n = otg_bounce_size(maxsize);
+  if (osp->rxsize > n) {
+    osp->rxsize = n;
+  }
+  return true;
+}
+#endif
+
+/**
+ * @brief   Loads a word from a buffer of any alignment.
+ *
+ * @param[in] p         pointer to the first byte
+ * @return              The word, little endian.
+ *
+ * @notapi
+ */
+static inline uint32_t otg_load_word(const uint8_t *p) {
+  uint32_t w;
+
+  memcpy(&w, p, 4);
+  return w;
+}
+
+/**
+ * @brief   Stores a word into a buffer of any alignment.
+ *
+ * @param[out] p        pointer to the first byte
+ * @param[in] w         the word, little endian
+ *
+ * @notapi
+ */
+static inline void otg_store_word(uint8_t *p, uint32_t w) {
+
+  memcpy(p, &w, 4);
 }
 
 /**
  * @brief   Writes to a TX FIFO.
+ * @details Word aligned buffers are moved in bursts of eight and four words,
+ *          unaligned buffers still use word loads. The last partial word is
+ *          padded, the buffer is never read past its end.
  *
  * @param[in] fifop     pointer to the FIFO register
  * @param[in] buf       buffer where to copy the endpoint data
@@ -233,21 +680,80 @@ static uint32_t otg_ram_alloc(USBDriver *usbp, size_t size) {
 static void otg_fifo_write_from_buffer(volatile uint32_t *fifop,
                                        const uint8_t *buf,
                                        size_t n) {
+  size_t words = n / 4U;
 
   osalDbgAssert(n > 0, "is zero");
 
-  while (true) {
-    *fifop = *((uint32_t *)buf);
-    if (n <= 4) {
-      break;
+  if (((uint32_t)buf & 3U) == 0U) {
+    const uint32_t *wp = (const uint32_t *)buf;
+
+    while (words >= 8U) {
+      uint32_t w0 = wp[0], w1 = wp[1], w2 = wp[2], w3 = wp[3];
+      uint32_t w4 = wp[4], w5 = wp[5], w6 = wp[6], w7 = wp[7];
+
+      *fifop = w0;
+      *fifop = w1;
+      *fifop = w2;
+      *fifop = w3;
+      *fifop = w4;
+      *fifop = w5;
+      *fifop = w6;
+      *fifop = w7;
+      wp    += 8;
+      words -= 8U;
+    }
+    if (words >= 4U) {
+      uint32_t w0 = wp[0], w1 = wp[1], w2 = wp[2], w3 = wp[3];
+
+      *fifop = w0;
+      *fifop = w1;
+      *fifop = w2;
+      *fifop = w3;
+      wp    += 4;
+      words -= 4U;
     }
-    n -= 4;
-    buf += 4;
+    while (words > 0U) {
+      *fifop = *wp++;
+      words--;
+    }
+    buf = (const uint8_t *)wp;
+  }
+  else {
+    while (words >= 4U) {
+      uint32_t w0 = otg_load_word(buf + 0);
+      uint32_t w1 = otg_load_word(buf + 4);
+      uint32_t w2 = otg_load_word(buf + 8);
+      uint32_t w3 = otg_load_word(buf + 12);
+
+      *fifop = w0;
+      *fifop = w1;
+      *fifop = w2;
+      *fifop = w3;
+      buf   += 16;
+      words -= 4U;
+    }
+    while (words > 0U) {
+      *fifop = otg_load_word(buf);
+      buf += 4;
+      words--;
+    }
+  }
+
+  /* Tail, partial last word.*/
+  n &= 3U;
+  if (n > 0U) {
+    uint32_t w = 0U;
+
+    memcpy(&w, buf, n);
+    *fifop = w;
   }
 }
 
 /**
  * @brief   Reads a packet from the RXFIFO.
+ * @details Whole words are stored directly, in bursts of eight and four
+ *          words if the buffer is word aligned. The words exceeding the
+ *          buffer size are popped and discarded.
  *
  * @param[in] fifop     pointer to the FIFO register
  * @param[out] buf      buffer where to copy the endpoint data
@@ -260,18 +766,70 @@ static void otg_fifo_read_to_buffer(volatile uint32_t *fifop,
                                     uint8_t *buf,
                                     size_t n,
                                     size_t max) {
-  uint32_t w = 0;
-  size_t i = 0;
+  size_t words = (n + 3U) / 4U;
+  size_t full;
 
-  while (i < n) {
-    if ((i & 3) == 0) {
-      w = *fifop;
+  if (max > n) {
+    max = n;
+  }
+  full   = max / 4U;
+  words -= full;
+
+  if (((uint32_t)buf & 3U) == 0U) {
+    uint32_t *wp = (uint32_t *)buf;
+
+    while (full >= 8U) {
+      uint32_t w0 = *fifop, w1 = *fifop, w2 = *fifop, w3 = *fifop;
+      uint32_t w4 = *fifop, w5 = *fifop, w6 = *fifop, w7 = *fifop;
+
+      wp[0] = w0;
+      wp[1] = w1;
+      wp[2] = w2;
+      wp[3] = w3;
+      wp[4] = w4;
+      wp[5] = w5;
+      wp[6] = w6;
+      wp[7] = w7;
+      wp   += 8;
+      full -= 8U;
     }
-    if (i < max) {
-      *buf++ = (uint8_t)w;
-      w >>= 8;
+    if (full >= 4U) {
+      uint32_t w0 = *fifop, w1 = *fifop, w2 = *fifop, w3 = *fifop;
+
+      wp[0] = w0;
+      wp[1] = w1;
+      wp[2] = w2;
+      wp[3] = w3;
+      wp   += 4;
+      full -= 4U;
     }
-    i++;
+    while (full > 0U) {
+      *wp++ = *fifop;
+      full--;
+    }
+    buf = (uint8_t *)wp;
+  }
+  else {
+    while (full > 0U) {
+      otg_store_word(buf, *fifop);
+      buf += 4;
+      full--;
+    }
+  }
+
+  /* Tail, partial last word.*/
+  max &= 3U;
+  if (max > 0U) {
+    uint32_t w = *fifop;
+
+    memcpy(buf, &w, max);
+    words--;
+  }
+
+  /* Discarding the data exceeding the buffer.*/
+  while (words > 0U) {
+    (void)*fifop;
+    words--;
   }
 }
 
@@ -384,6 +942,19 @@ static void otg_epin_handler(USBDriver *usbp, usbep_t ep) {
     /* Transmit transfer complete.*/
     USBInEndpointState *isp = usbp->epc[ep]->in_state;
 
+#if STM32_USB_USE_ISO_STREAM == TRUE
+    if (usbp->isoin[ep] != NULL) {
+      otg_iso_serve_xfrc(usbp, usbp->isoin[ep]);
+      return;
+    }
+#endif
+
+    if (otg_dma_mode(usbp)) {
+      /* The whole transaction has been moved by the core DMA.*/
+      isp->txbuf += isp->txsize;
+      isp->txcnt  = isp->txsize;
+    }
+
     if (isp->txsize < isp->totsize) {
       /* In case the transaction covered only part of the total transfer
          then another transaction is immediately started in order to
@@ -397,6 +968,11 @@ static void otg_epin_handler(USBDriver *usbp, usbep_t ep) {
     else {
       /* End on IN transfer.*/
       _usb_isr_invoke_in_cb(usbp, ep);
+#if STM32_USB_OTG2_USE_DMA
+      if (otg_dma_mode(usbp) && (ep == 0)) {
+        otg_ep0_dma_setup(usbp);
+      }
+#endif
     }
   }
   if ((epint & DIEPINT_TXFE) &&
@@ -422,6 +998,13 @@ static void otg_epout_handler(USBDriver *usbp, usbep_t ep) {
   otgp->oe[ep].DOEPINT = epint;
 
   if ((epint & DOEPINT_STUP) && (otgp->DOEPMSK & DOEPMSK_STUPM)) {
+#if STM32_USB_OTG2_USE_DMA
+    if (otg_dma_mode(usbp)) {
+      /* The last received setup packet precedes the DMA pointer.*/
+      memcpy(usbp->epc[ep]->setup_buf,
+             (const uint8_t *)(otgp->oe[ep].DOEPDMA - 8U), 8);
+    }
+#endif
     /* Setup packets handling, setup packets are handled using a
        specific callback.*/
     _usb_isr_invoke_setup_cb(usbp, ep);
@@ -433,6 +1016,57 @@ static void otg_epout_handler(USBDriver *usbp, usbep_t ep) {
     /* OUT state structure pointer for this endpoint.*/
     osp = usbp->epc[ep]->out_state;
 
+#if STM32_USB_OTG2_USE_DMA
+    if (otg_dma_mode(usbp)) {
+      uint32_t cnt;
+
+      /* Completion of the setup area arming, not a data transaction.*/
+      if ((ep == 0) && ((usbp->ep0state & USB_OUT_STATE) == 0)) {
+        otg_ep0_dma_setup(usbp);
+        return;
+      }
+
+      /* Received size is the programmed size minus the residual.*/
+      cnt = otg_out_xfrsize(usbp, ep, NULL) -
+            (otgp->oe[ep].DOEPTSIZ & DOEPTSIZ_XFRSIZ_MASK);
+      if ((otg_bounce.out_active & (1U << ep)) != 0U) {
+        size_t n = cnt < osp->rxsize ? cnt : osp->rxsize;
+
+        otg_bounce.out_active &= ~(1U << ep);
+        if (n > 0U) {
+          memcpy(osp->rxbuf, otg_bounce.out[ep], n);
+        }
+      }
+      osp->rxbuf += cnt;
+      osp->rxcnt += cnt;
+
+      /* The transfer continues if the transaction has been reduced and
+         it has not been terminated by a short packet.*/
+      if (((cnt % usbp->epc[ep]->out_maxsize) == 0U) &&
+          (cnt >= osp->rxsize) && (osp->rxsize < osp->totsize)) {
+        osp->rxsize = osp->totsize - osp->rxsize;
+        osalSysLockFromISR();
+        usb_lld_start_out(usbp, ep);
+        osalSysUnlockFromISR();
+        return;
+      }
+    }
+#endif
+
+#if STM32_USB_USE_OUT_STREAM == TRUE
+    if (usbp->ostream[ep] != NULL) {
+      otg_stream_serve_out(usbp, ep);
+      return;
+    }
+#endif
+
+#if STM32_USB_USE_ISO_STREAM == TRUE
+    if (usbp->isoout[ep] != NULL) {
+      otg_iso_serve_xfrc(usbp, usbp->isoout[ep]);
+      return;
+    }
+#endif
+
     /* EP0 requires special handling.*/
     if (ep == 0) {
 
@@ -461,6 +1095,11 @@ static void otg_epout_handler(USBDriver *usbp, usbep_t ep) {
 
     /* End on OUT transfer.*/
     _usb_isr_invoke_out_cb(usbp, ep);
+#if STM32_USB_OTG2_USE_DMA
+    if (otg_dma_mode(usbp) && (ep == 0)) {
+      otg_ep0_dma_setup(usbp);
+    }
+#endif
   }
 }
 
@@ -487,6 +1126,17 @@ static void otg_isoc_in_failed_handler(USBDriver *usbp) {
       /* Flush FIFO.*/
       otg_txfifo_flush(usbp, ep);
 
+#if STM32_USB_USE_ISO_STREAM == TRUE
+      if (usbp->isoin[ep] != NULL) {
+        /* The same frame buffer is sent again in the next frame.*/
+        usbp->isoin[ep]->missed++;
+        osalSysLockFromISR();
+        (void)otg_iso_arm(usbp, usbp->isoin[ep]);
+        osalSysUnlockFromISR();
+        continue;
+      }
+#endif
+
       /* Prepare data for next frame.*/
       _usb_isr_invoke_in_cb(usbp, ep);
     }
@@ -515,6 +1165,18 @@ static void otg_isoc_out_failed_handler(USBDriver *usbp) {
       while (otgp->oe[ep].DOEPCTL & DOEPCTL_EPENA)
         ;
 #endif
+#if STM32_USB_USE_ISO_STREAM == TRUE
+      if (usbp->isoout[ep] != NULL) {
+        /* Still armed, retargeted to the next frame.*/
+        usbp->isoout[ep]->missed++;
+        if (otgp->DSTS & DSTS_FNSOF_ODD)
+          otgp->oe[ep].DOEPCTL |= DOEPCTL_SEVNFRM;
+        else
+          otgp->oe[ep].DOEPCTL |= DOEPCTL_SODDFRM;
+        continue;
+      }
+#endif
+
       /* Prepare transfer for next frame.*/
       _usb_isr_invoke_out_cb(usbp, ep);
     }
@@ -557,6 +1219,13 @@ static void usb_lld_serve_interrupt(USBDriver *usbp) {
     /* Clear the Remote Wake-up Signaling.*/
     otgp->DCTL &= ~DCTL_RWUSIG;
 
+#if STM32_USB_OTG2_USE_DMA
+    /* EP0 has been disabled on suspend.*/
+    if (otg_dma_mode(usbp)) {
+      otg_ep0_dma_setup(usbp);
+    }
+#endif
+
     _usb_wakeup(usbp);
   }
 
@@ -584,6 +1253,9 @@ static void usb_lld_serve_interrupt(USBDriver *usbp) {
 
   /* SOF interrupt handling.*/
   if (sts & GINTSTS_SOF) {
+#if STM32_USB_USE_ISO_STREAM == TRUE
+    otg_iso_serve_sof(usbp);
+#endif
     _usb_isr_invoke_sof_cb(usbp);
   }
 
@@ -598,7 +1270,7 @@ static void usb_lld_serve_interrupt(USBDriver *usbp) {
   }
 
   /* Performing the whole FIFO emptying in the ISR, it is advised to keep
-     this IRQ at a very low priority level.*/
+     this IRQ at a very low priority level. Not enabled in DMA mode.*/
   if ((sts & GINTSTS_RXFLVL) != 0U) {
     otg_rxfifo_handler(usbp);
   }
@@ -835,8 +1507,8 @@ void usb_lld_start(USBDriver *usbp) {
     /* Soft core reset.*/
     otg_core_reset(usbp);
 
-    /* Interrupts on TXFIFOs half empty.*/
-    otgp->GAHBCFG = 0;
+    /* Interrupts on TXFIFOs half empty, core DMA if enabled.*/
+    otgp->GAHBCFG = otg_dma_mode(usbp) ? GAHBCFG_DMA_INIT : 0U;
 
     /* Endpoints re-initialization.*/
     otg_disable_ep(usbp);
@@ -933,6 +1605,19 @@ void usb_lld_reset(USBDriver *usbp) {
   /* Resets the FIFO memory allocator.*/
   otg_ram_reset(usbp);
 
+#if STM32_USB_USE_OUT_STREAM == TRUE
+  /* Streams are detached, the endpoints no longer exist.*/
+  for (i = 0; i <= usbp->otgparams->num_endpoints; i++) {
+    usbp->ostream[i] = NULL;
+  }
+#endif
+#if STM32_USB_USE_ISO_STREAM == TRUE
+  for (i = 0; i <= usbp->otgparams->num_endpoints; i++) {
+    usbp->isoin[i]  = NULL;
+    usbp->isoout[i] = NULL;
+  }
+#endif
+
   /* Receive FIFO size initialization, the address is always zero.*/
   otgp->GRXFSIZ = usbp->otgparams->rx_fifo_size;
   otg_rxfifo_flush(usbp);
@@ -940,8 +1625,14 @@ void usb_lld_reset(USBDriver *usbp) {
   /* Resets the device address to zero.*/
   otgp->DCFG = (otgp->DCFG & ~DCFG_DAD_MASK) | DCFG_DAD(0);
 
-  /* Enables also EP-related interrupt sources.*/
-  otgp->GINTMSK  |= GINTMSK_RXFLVLM | GINTMSK_OEPM  | GINTMSK_IEPM;
+  /* Enables also EP-related interrupt sources, in DMA mode the RX FIFO
+     is emptied by the core.*/
+  if (otg_dma_mode(usbp)) {
+    otgp->GINTMSK |= GINTMSK_OEPM  | GINTMSK_IEPM;
+  }
+  else {
+    otgp->GINTMSK |= GINTMSK_RXFLVLM | GINTMSK_OEPM  | GINTMSK_IEPM;
+  }
   otgp->DIEPMSK   = DIEPMSK_TOCM    | DIEPMSK_XFRCM;
   otgp->DOEPMSK   = DOEPMSK_STUPM   | DOEPMSK_XFRCM;
 
@@ -954,8 +1645,14 @@ void usb_lld_reset(USBDriver *usbp) {
   otgp->ie[0].DIEPCTL = DIEPCTL_SD0PID | DIEPCTL_USBAEP | DIEPCTL_EPTYP_CTRL |
                         DIEPCTL_TXFNUM(0) | DIEPCTL_MPSIZ(ep0config.in_maxsize);
   otgp->DIEPTXF0 = DIEPTXF_INEPTXFD(ep0config.in_maxsize / 4) |
-                   DIEPTXF_INEPTXSA(otg_ram_alloc(usbp,
+                   DIEPTXF_INEPTXSA(otg_ram_alloc(usbp, 0,
                                                   ep0config.in_maxsize / 4));
+
+#if STM32_USB_OTG2_USE_DMA
+  if (otg_dma_mode(usbp)) {
+    otg_ep0_dma_setup(usbp);
+  }
+#endif
 }
 
 /**
@@ -1015,12 +1712,11 @@ void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep) {
   /* IN endpoint activation or deactivation.*/
   otgp->ie[ep].DIEPTSIZ = 0;
   if (usbp->epc[ep]->in_state != NULL) {
-    /* FIFO allocation for the IN endpoint.*/
-    fsize = usbp->epc[ep]->in_maxsize / 4;
-    if (usbp->epc[ep]->in_multiplier > 1)
-      fsize *= usbp->epc[ep]->in_multiplier;
+    /* FIFO allocation for the IN endpoint, a previous allocation of the
+       same endpoint is reclaimed.*/
+    fsize = otg_txfifo_size(usbp, ep);
     otgp->DIEPTXF[ep - 1] = DIEPTXF_INEPTXFD(fsize) |
-                            DIEPTXF_INEPTXSA(otg_ram_alloc(usbp, fsize));
+                            DIEPTXF_INEPTXSA(otg_ram_alloc(usbp, ep, fsize));
     otg_txfifo_flush(usbp, ep);
 
     otgp->ie[ep].DIEPCTL = ctl |
@@ -1029,6 +1725,7 @@ void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep) {
     otgp->DAINTMSK |= DAINTMSK_IEPM(ep);
   }
   else {
+    otg_ram_free(usbp, ep);
     otgp->DIEPTXF[ep - 1] = 0x02000400; /* Reset value.*/
     otg_txfifo_flush(usbp, ep);
     otgp->ie[ep].DIEPCTL &= ~DIEPCTL_USBAEP;
@@ -1044,9 +1741,19 @@ void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep) {
  * @notapi
  */
 void usb_lld_disable_endpoints(USBDriver *usbp) {
+  usbep_t ep;
 
-  /* Resets the FIFO memory allocator.*/
-  otg_ram_reset(usbp);
+  /* Releases the FIFO memory, EP0 keeps its TX FIFO.*/
+  for (ep = 1; ep <= usbp->otgparams->num_endpoints; ep++) {
+    otg_ram_free(usbp, ep);
+#if STM32_USB_USE_OUT_STREAM == TRUE
+    usbp->ostream[ep] = NULL;
+#endif
+#if STM32_USB_USE_ISO_STREAM == TRUE
+    usbp->isoin[ep]  = NULL;
+    usbp->isoout[ep] = NULL;
+#endif
+  }
 
   /* Disabling all endpoints.*/
   otg_disable_ep(usbp);
@@ -1138,14 +1845,23 @@ void usb_lld_start_out(USBDriver *usbp, usbep_t ep) {
   if ((ep == 0) && (osp->rxsize > EP0_MAX_OUTSIZE))
       osp->rxsize = EP0_MAX_OUTSIZE;
 
-  /* Transaction size is rounded to a multiple of packet size because the
-     following requirement in the RM:
-     "For OUT transfers, the transfer size field in the endpoint's transfer
-     size register must be a multiple of the maximum packet size of the
-     endpoint, adjusted to the Word boundary".*/
-  pcnt   = (osp->rxsize + usbp->epc[ep]->out_maxsize - 1U) /
-           usbp->epc[ep]->out_maxsize;
-  rxsize = (pcnt * usbp->epc[ep]->out_maxsize + 3U) & 0xFFFFFFFCU;
+#if STM32_USB_OTG2_USE_DMA
+  /* Buffer DMA mode, the core writes the packets directly in the buffer
+     unless it is unaligned or the transaction would overflow it.*/
+  if (otg_dma_mode(usbp)) {
+    if (otg_dma_out_bounce(usbp, ep)) {
+      otg_bounce.out_active |= 1U << ep;
+      usbp->otg->oe[ep].DOEPDMA = (uint32_t)otg_bounce.out[ep];
+    }
+    else {
+      otg_bounce.out_active &= ~(1U << ep);
+      usbp->otg->oe[ep].DOEPDMA = (uint32_t)osp->rxbuf;
+    }
+  }
+#endif
+
+  /* Transaction size is rounded to a multiple of packet size.*/
+  rxsize = otg_out_xfrsize(usbp, ep, &pcnt);
 
   /* Setting up transaction parameters in DOEPTSIZ.*/
   usbp->otg->oe[ep].DOEPTSIZ = DOEPTSIZ_STUPCNT(3) | DOEPTSIZ_PKTCNT(pcnt) |
@@ -1185,6 +1901,18 @@ void usb_lld_start_in(USBDriver *usbp, usbep_t ep) {
     if ((ep == 0) && (isp->txsize > EP0_MAX_INSIZE))
       isp->txsize = EP0_MAX_INSIZE;
 
+#if STM32_USB_OTG2_USE_DMA
+    /* Unaligned buffers are sent from the bounce buffer, the transfer is
+       split if it does not fit.*/
+    if (otg_dma_mode(usbp) && (((uint32_t)isp->txbuf & 3U) != 0U)) {
+      size_t n = otg_bounce_size(usbp->epc[ep]->in_maxsize);
+
+      if (isp->txsize > n) {
+        isp->txsize = n;
+      }
+    }
+#endif
+
     /* Normal case.*/
     uint32_t pcnt = (isp->txsize + usbp->epc[ep]->in_maxsize - 1) /
                     usbp->epc[ep]->in_maxsize;
@@ -1202,6 +1930,22 @@ void usb_lld_start_in(USBDriver *usbp, usbep_t ep) {
       usbp->otg->ie[ep].DIEPCTL |= DIEPCTL_SODDFRM;
   }
 
+#if STM32_USB_OTG2_USE_DMA
+  /* Buffer DMA mode, the core fetches the packets directly from the
+     buffer, the TX FIFO empty interrupt is not used.*/
+  if (otg_dma_mode(usbp)) {
+    if (((uint32_t)isp->txbuf & 3U) != 0U) {
+      memcpy(otg_bounce.in[ep], isp->txbuf, isp->txsize);
+      usbp->otg->ie[ep].DIEPDMA = (uint32_t)otg_bounce.in[ep];
+    }
+    else {
+      usbp->otg->ie[ep].DIEPDMA = (uint32_t)isp->txbuf;
+    }
+    usbp->otg->ie[ep].DIEPCTL |= DIEPCTL_EPENA | DIEPCTL_CNAK;
+    return;
+  }
+#endif
+
   /* Starting operation.*/
   usbp->otg->ie[ep].DIEPCTL |= DIEPCTL_EPENA | DIEPCTL_CNAK;
   usbp->otg->DIEPEMPMSK |= DIEPEMPMSK_INEPTXFEM(ep);
@@ -1259,6 +2003,243 @@ void usb_lld_clear_in(USBDriver *usbp, usbep_t ep) {
   usbp->otg->ie[ep].DIEPCTL &= ~DIEPCTL_STALL;
 }
 
+#if (STM32_USB_USE_OUT_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a streaming receive on an OUT endpoint.
+ * @details The endpoint is armed on the buffers of the ring in sequence,
+ *          each buffer is completed when full or on a short packet. The
+ *          endpoint is re-armed from the ISR as long as there are free
+ *          buffers so the host can send back-to-back.
+ * @note    Completed buffers must be returned with
+ *          @p usbSTM32ReleaseReceiveBuffersI(), the endpoint NAKs while
+ *          all the buffers are waiting to be released.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number, not zero
+ * @param[in] sp        pointer to the stream, the configuration fields
+ *                      must be initialized
+ *
+ * @iclass
+ */
+void usbSTM32StartReceiveStreamI(USBDriver *usbp, usbep_t ep,
+                                 USBOutStream *sp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((ep > 0U) && (sp != NULL) && (sp->bufs != NULL) &&
+               (sp->lengths != NULL) && (sp->nbufs > 0U) &&
+               (sp->cb != NULL));
+  osalDbgAssert((sp->bufsize > 0U) &&
+                ((sp->bufsize % usbp->epc[ep]->out_maxsize) == 0U),
+                "buffer size not a multiple of the packet size");
+  osalDbgAssert((usbp->receiving & (1U << ep)) == 0U, "endpoint busy");
+
+  sp->head  = 0U;
+  sp->tail  = 0U;
+  sp->count = 0U;
+  usbp->ostream[ep] = sp;
+
+  /* The endpoint is marked as receiving for the whole stream duration, the
+     standard receive API is refused meanwhile.*/
+  usbp->receiving |= (uint16_t)(1U << ep);
+  otg_stream_arm(usbp, ep);
+}
+
+/**
+ * @brief   Stops a streaming receive on an OUT endpoint.
+ * @details If a transaction is armed the endpoint is disabled, data
+ *          received meanwhile is discarded. The buffers are no more
+ *          accessed by the driver on return.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @iclass
+ */
+void usbSTM32StopReceiveStreamI(USBDriver *usbp, usbep_t ep) {
+  stm32_otg_t *otgp = usbp->otg;
+
+  osalDbgCheckClassI();
+
+  if (usbp->ostream[ep] == NULL) {
+    return;
+  }
+
+  if ((otgp->oe[ep].DOEPCTL & DOEPCTL_EPENA) != 0U) {
+    /* OUT endpoints can only be disabled under global OUT NAK, a transfer
+       completion racing with the disable is discarded.*/
+    otgp->DCTL |= DCTL_SGONAK;
+    while ((otgp->GINTSTS & GINTSTS_GONAKEFF) == 0U)
+      ;
+    otgp->oe[ep].DOEPCTL |= (DOEPCTL_EPDIS | DOEPCTL_SNAK);
+    while ((otgp->oe[ep].DOEPINT & DOEPINT_EPDISD) == 0U)
+      ;
+    otgp->oe[ep].DOEPINT = DOEPINT_EPDISD | DOEPINT_XFRC;
+    otgp->DCTL |= DCTL_CGONAK;
+  }
+
+  usbp->ostream[ep] = NULL;
+  usbp->receiving  &= ~(uint16_t)(1U << ep);
+}
+
+/**
+ * @brief   Releases completed buffers of a streaming OUT endpoint.
+ * @details The oldest @p n completed buffers are returned to the ring, if
+ *          the endpoint was starved it is armed again.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @param[in] n         number of buffers to release
+ *
+ * @iclass
+ */
+void usbSTM32ReleaseReceiveBuffersI(USBDriver *usbp, usbep_t ep,
+                                    unsigned n) {
+  USBOutStream *sp = usbp->ostream[ep];
+
+  osalDbgCheckClassI();
+  osalDbgCheck(sp != NULL);
+  osalDbgAssert(n <= sp->count, "releasing more than completed");
+
+  sp->tail   = (sp->tail + n) % sp->nbufs;
+  sp->count -= n;
+
+  otg_stream_arm(usbp, ep);
+}
+#endif
+
+#if (STM32_USB_USE_ISO_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an isochronous stream.
+ * @details The SOF interrupt is enabled for the stream duration. IN
+ *          streams start with all the buffers free, OUT streams start with
+ *          all the buffers available for reception.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        isochronous endpoint number
+ * @param[in] sp        pointer to the stream, the configuration fields
+ *                      must be initialized
+ *
+ * @iclass
+ */
+void usbSTM32StartIsoStreamI(USBDriver *usbp, usbep_t ep, USBIsoStream *sp) {
+  uint16_t mask = (uint16_t)(1U << ep);
+
+  osalDbgCheckClassI();
+  osalDbgCheck((ep > 0U) && (sp != NULL) && (sp->bufs != NULL) &&
+               (sp->lengths != NULL) && (sp->nbufs > 0U) &&
+               (sp->cb != NULL));
+  osalDbgAssert((usbp->epc[ep]->ep_mode & USB_EP_MODE_TYPE) ==
+                USB_EP_MODE_TYPE_ISOC, "not an isochronous endpoint");
+
+  sp->ep        = ep;
+  sp->head      = 0U;
+  sp->count     = 0U;
+  sp->frames    = 0U;
+  sp->underruns = 0U;
+  sp->overruns  = 0U;
+  sp->missed    = 0U;
+  sp->stopping  = false;
+
+  if (sp->in) {
+    osalDbgAssert((usbp->transmitting & mask) == 0U, "endpoint busy");
+    usbp->transmitting |= mask;
+    usbp->isoin[ep] = sp;
+  }
+  else {
+    osalDbgAssert((usbp->receiving & mask) == 0U, "endpoint busy");
+    usbp->receiving |= mask;
+    usbp->isoout[ep] = sp;
+    (void)otg_iso_arm(usbp, sp);
+  }
+
+  usbp->otg->GINTMSK |= GINTMSK_SOFM;
+}
+
+/**
+ * @brief   Stops an isochronous stream.
+ * @details An IN endpoint is disabled and its FIFO flushed immediately, an
+ *          armed OUT endpoint is detached on its next completion.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] sp        pointer to the isochronous stream
+ *
+ * @iclass
+ */
+void usbSTM32StopIsoStreamI(USBDriver *usbp, USBIsoStream *sp) {
+  stm32_otg_t *otgp = usbp->otg;
+  usbep_t ep = sp->ep;
+
+  osalDbgCheckClassI();
+
+  if (sp->in) {
+    if ((otgp->ie[ep].DIEPCTL & DIEPCTL_EPENA) != 0U) {
+      otgp->ie[ep].DIEPCTL |= (DIEPCTL_EPDIS | DIEPCTL_SNAK);
+      while (otgp->ie[ep].DIEPCTL & DIEPCTL_EPENA)
+        ;
+      otg_txfifo_flush(usbp, ep);
+    }
+    otgp->DIEPEMPMSK   &= ~DIEPEMPMSK_INEPTXFEM(ep);
+    usbp->isoin[ep]     = NULL;
+    usbp->transmitting &= ~(uint16_t)(1U << ep);
+  }
+  else {
+    if ((otgp->oe[ep].DOEPCTL & DOEPCTL_EPENA) != 0U) {
+      sp->stopping = true;
+    }
+    else {
+      usbp->isoout[ep] = NULL;
+      usbp->receiving &= ~(uint16_t)(1U << ep);
+    }
+  }
+
+  /* SOF kept enabled only if required by the application.*/
+  if (usbp->config->sof_cb == NULL) {
+    bool active = false;
+
+    for (ep = 1; ep <= usbp->otgparams->num_endpoints; ep++) {
+      active |= (usbp->isoin[ep] != NULL) || (usbp->isoout[ep] != NULL);
+    }
+    if (!active) {
+      otgp->GINTMSK &= ~GINTMSK_SOFM;
+    }
+  }
+}
+
+/**
+ * @brief   Moves buffers between the application and the stream.
+ * @details IN streams: @p n filled buffers, starting from the first free
+ *          one, are queued for transmission, their lengths must have been
+ *          written in the @p lengths array.
+ *          OUT streams: the @p n oldest received buffers are returned to
+ *          the stream.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] sp        pointer to the isochronous stream
+ * @param[in] n         number of buffers
+ *
+ * @iclass
+ */
+void usbSTM32IsoAdvanceI(USBDriver *usbp, USBIsoStream *sp, unsigned n) {
+
+  osalDbgCheckClassI();
+
+  if (sp->in) {
+    osalDbgAssert(sp->count + n <= sp->nbufs, "ring overflow");
+    sp->count += n;
+  }
+  else {
+    osalDbgAssert(n <= sp->count, "returning more than received");
+    sp->count -= n;
+  }
+
+  /* Arming is otherwise left to the SOF, the first IN frame or an
+     overrun OUT stream restart here.*/
+  if (!sp->stopping) {
+    (void)otg_iso_arm(usbp, sp);
+  }
+}
+#endif
+
 #endif /* HAL_USE_USB */
 
 /** @} */
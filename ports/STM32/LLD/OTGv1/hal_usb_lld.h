@@ -109,6 +109,65 @@
 #define STM32_USE_USB_OTG2_HS               TRUE
 #endif
 
+/**
+ * @brief   Enables the OTG2 internal DMA (buffer DMA mode).
+ * @details If set to @p TRUE the endpoints buffers are transferred by the
+ *          core DMA through the DIEPDMA/DOEPDMA registers instead of being
+ *          copied to and from the FIFOs by the USB ISR.
+ * @note    Unaligned buffers and OUT buffers not holding a whole number
+ *          of packets are moved through a per-endpoint bounce buffer.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_USB_OTG2_USE_DMA) || defined(__DOXYGEN__)
+#define STM32_USB_OTG2_USE_DMA              FALSE
+#endif
+
+/**
+ * @brief   Size of the OTG2 per-endpoint DMA bounce buffers.
+ * @details Transfers that cannot target the application buffer directly
+ *          are split in transactions of this size at most.
+ * @note    It must be a multiple of four and not less than the largest
+ *          packet size of the endpoints, it can be reduced to 64 if all
+ *          the endpoints use full speed packet sizes.
+ */
+#if !defined(STM32_USB_OTG2_DMA_BOUNCE_SIZE) || defined(__DOXYGEN__)
+#define STM32_USB_OTG2_DMA_BOUNCE_SIZE      512
+#endif
+
+/**
+ * @brief   Double buffered TX FIFOs for bulk and isochronous IN endpoints.
+ * @details If set to @p TRUE the bulk and isochronous IN endpoints with an
+ *          @p in_multiplier lower than two are given a TX FIFO of two
+ *          packets, if the FIFO RAM allows it, so that the next packet can
+ *          be loaded while the previous one is on the bus.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_USB_OTG_TXFIFO_DOUBLE_BUFFER) || defined(__DOXYGEN__)
+#define STM32_USB_OTG_TXFIFO_DOUBLE_BUFFER  FALSE
+#endif
+
+/**
+ * @brief   Streaming OUT endpoints support.
+ * @details If set to @p TRUE the @p usbSTM32StartReceiveStreamI() API is
+ *          included, an OUT endpoint is kept armed on a ring of buffers
+ *          and the completed buffers are reported in batches.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_USB_USE_OUT_STREAM) || defined(__DOXYGEN__)
+#define STM32_USB_USE_OUT_STREAM            FALSE
+#endif
+
+/**
+ * @brief   Isochronous streaming support.
+ * @details If set to @p TRUE the @p usbSTM32StartIsoStreamI() API is
+ *          included, an isochronous endpoint moves one frame buffer of a
+ *          ring per (micro)frame, the application is called back on SOF.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_USB_USE_ISO_STREAM) || defined(__DOXYGEN__)
+#define STM32_USB_USE_ISO_STREAM            FALSE
+#endif
+
 /**
  * @brief   Exception priority level during TXFIFOs operations.
  * @note    Because an undocumented silicon behavior the operation of
@@ -213,6 +272,16 @@
 #error "Invalid IRQ priority assigned to OTG2"
 #endif
 
+#if STM32_USB_OTG2_USE_DMA && !STM32_USB_USE_OTG2
+#error "OTG2 DMA mode enabled but OTG2 not in use"
+#endif
+
+#if STM32_USB_OTG2_USE_DMA &&                                               \
+    ((STM32_USB_OTG2_DMA_BOUNCE_SIZE < 64) ||                               \
+     ((STM32_USB_OTG2_DMA_BOUNCE_SIZE & 3) != 0))
+#error "invalid STM32_USB_OTG2_DMA_BOUNCE_SIZE value"
+#endif
+
 #if (STM32_USB_OTG1_RX_FIFO_SIZE & 3) != 0
 #error "OTG1 RX FIFO size must be a multiple of 4"
 #endif
@@ -261,8 +330,163 @@ typedef struct {
   uint32_t                      rx_fifo_size;
   uint32_t                      otg_ram_size;
   uint32_t                      num_endpoints;
+  bool                          use_dma;
 } stm32_otg_params_t;
 
+/**
+ * @brief   Type of a TX FIFO allocation in the FIFO RAM.
+ */
+typedef struct {
+  /**
+   * @brief   Start address in words.
+   */
+  uint16_t                      start;
+  /**
+   * @brief   Size in words, zero if not allocated.
+   */
+  uint16_t                      size;
+} stm32_otg_txfifo_t;
+
+#if (STM32_USB_USE_OUT_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Streaming OUT endpoint notification callback type.
+ * @details Invoked from the USB ISR each time a buffer is completed, the
+ *          endpoint has already been re-armed on the next free buffer.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @param[in] first     index of the oldest completed buffer not yet
+ *                      released
+ * @param[in] n         number of completed buffers not yet released, the
+ *                      lengths are in the @p lengths array of the stream
+ */
+typedef void (*usbstreamcb_t)(USBDriver *usbp, usbep_t ep,
+                              unsigned first, unsigned n);
+
+/**
+ * @brief   Type of a streaming OUT endpoint.
+ */
+typedef struct {
+  /**
+   * @brief   Array of @p nbufs buffers.
+   * @note    Buffers must be word aligned in DMA mode.
+   */
+  uint8_t * const               *bufs;
+  /**
+   * @brief   Array of @p nbufs received lengths.
+   */
+  size_t                        *lengths;
+  /**
+   * @brief   Number of buffers in the ring.
+   */
+  unsigned                      nbufs;
+  /**
+   * @brief   Size of each buffer, a multiple of the packet size.
+   */
+  size_t                        bufsize;
+  /**
+   * @brief   Buffer completion callback.
+   */
+  usbstreamcb_t                 cb;
+  /* End of the configuration fields.*/
+  /**
+   * @brief   Buffer being filled by the endpoint.
+   */
+  unsigned                      head;
+  /**
+   * @brief   Oldest completed buffer not yet released.
+   */
+  unsigned                      tail;
+  /**
+   * @brief   Completed buffers not yet released.
+   */
+  unsigned                      count;
+} USBOutStream;
+#endif
+
+#if (STM32_USB_USE_ISO_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Isochronous stream notification callback type.
+ * @details Invoked from the USB ISR on each SOF.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @param[in] first     IN: index of the first free buffer to be filled,
+ *                      OUT: index of the oldest received buffer
+ * @param[in] n         IN: number of free buffers,
+ *                      OUT: number of received buffers
+ */
+typedef void (*usbisocb_t)(USBDriver *usbp, usbep_t ep,
+                           unsigned first, unsigned n);
+
+/**
+ * @brief   Type of an isochronous stream.
+ * @details IN streams transmit the filled buffers one per frame, the
+ *          application fills the free buffers and queues them with
+ *          @p usbSTM32IsoAdvanceI(). OUT streams receive one buffer per
+ *          frame, the application consumes them and returns them with
+ *          @p usbSTM32IsoAdvanceI().
+ */
+typedef struct {
+  /**
+   * @brief   Stream direction, @p true for an IN endpoint.
+   */
+  bool                          in;
+  /**
+   * @brief   Array of @p nbufs frame buffers of one packet each.
+   * @note    Buffers must be word aligned in DMA mode.
+   */
+  uint8_t * const               *bufs;
+  /**
+   * @brief   Array of @p nbufs lengths, written by the application for IN
+   *          streams and by the driver for OUT streams.
+   */
+  size_t                        *lengths;
+  /**
+   * @brief   Number of buffers in the ring.
+   */
+  unsigned                      nbufs;
+  /**
+   * @brief   SOF refill/consume callback.
+   */
+  usbisocb_t                    cb;
+  /* End of the configuration fields.*/
+  /**
+   * @brief   Endpoint number.
+   */
+  usbep_t                       ep;
+  /**
+   * @brief   Next buffer used by the endpoint.
+   */
+  unsigned                      head;
+  /**
+   * @brief   IN: filled buffers queued, including the one being sent.
+   *          OUT: received buffers not yet returned.
+   */
+  unsigned                      count;
+  /**
+   * @brief   Frames transferred.
+   */
+  uint32_t                      frames;
+  /**
+   * @brief   IN frames without a filled buffer.
+   */
+  uint32_t                      underruns;
+  /**
+   * @brief   OUT frames without a free buffer.
+   */
+  uint32_t                      overruns;
+  /**
+   * @brief   Frames missed by the core, incomplete isochronous transfers.
+   */
+  uint32_t                      missed;
+  /**
+   * @brief   Stop requested while an OUT transaction was armed.
+   */
+  bool                          stopping;
+} USBIsoStream;
+#endif
+
 /**
  * @brief   Type of an IN endpoint state structure.
  */
@@ -502,9 +726,25 @@ struct USBDriver {
    */
   const stm32_otg_params_t      *otgparams;
   /**
-   * @brief   Pointer to the next address in the packet memory.
+   * @brief   TX FIFOs allocated in the FIFO RAM, one for each IN endpoint.
    */
-  uint32_t                      pmnext;
+  stm32_otg_txfifo_t            txfifo[USB_MAX_ENDPOINTS + 1];
+#if (STM32_USB_USE_OUT_STREAM == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Streams attached to the OUT endpoints.
+   */
+  USBOutStream                  *ostream[USB_MAX_ENDPOINTS + 1];
+#endif
+#if (STM32_USB_USE_ISO_STREAM == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Isochronous streams attached to the IN endpoints.
+   */
+  USBIsoStream                  *isoin[USB_MAX_ENDPOINTS + 1];
+  /**
+   * @brief   Isochronous streams attached to the OUT endpoints.
+   */
+  USBIsoStream                  *isoout[USB_MAX_ENDPOINTS + 1];
+#endif
 };
 
 /*===========================================================================*/
@@ -593,6 +833,19 @@ extern "C" {
   void usb_lld_stall_in(USBDriver *usbp, usbep_t ep);
   void usb_lld_clear_out(USBDriver *usbp, usbep_t ep);
   void usb_lld_clear_in(USBDriver *usbp, usbep_t ep);
+#if STM32_USB_USE_OUT_STREAM == TRUE
+  void usbSTM32StartReceiveStreamI(USBDriver *usbp, usbep_t ep,
+                                   USBOutStream *sp);
+  void usbSTM32StopReceiveStreamI(USBDriver *usbp, usbep_t ep);
+  void usbSTM32ReleaseReceiveBuffersI(USBDriver *usbp, usbep_t ep,
+                                      unsigned n);
+#endif
+#if STM32_USB_USE_ISO_STREAM == TRUE
+  void usbSTM32StartIsoStreamI(USBDriver *usbp, usbep_t ep,
+                               USBIsoStream *sp);
+  void usbSTM32StopIsoStreamI(USBDriver *usbp, USBIsoStream *sp);
+  void usbSTM32IsoAdvanceI(USBDriver *usbp, USBIsoStream *sp, unsigned n);
+#endif
 #ifdef __cplusplus
 }
 #endif
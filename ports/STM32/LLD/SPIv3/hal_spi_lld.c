@@ -75,12 +75,173 @@ static uint32_t dummyrx /*PLATFORM_SECTION_DMA*/ ;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if !defined(STM32U5) // STM32U5 PORT
 static void spi_lld_wait_complete(SPIDriver *spip) {
 
   while ((spip->spi->CR1 & SPI_CR1_CSTART) != 0) {
   }
   spip->spi->IFCR = 0xFFFFFFFF;
 }
+#else
+/**
+ * @brief   Prepares the SPI for a new operation.
+ * @details Operations are completed on the SPI end of transfer interrupt,
+ *          the driver only becomes ready after the SPI stopped so there is
+ *          nothing to wait for, the status flags are cleared.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ */
+static void spi_lld_wait_complete(SPIDriver *spip) {
+
+  osalDbgAssert((spip->spi->CR1 & SPI_CR1_CSTART) == 0U, "SPI not idle");
+
+  spip->spi->IFCR = 0xFFFFFFFFU;
+}
+
+/**
+ * @brief   Suspends the SPI and waits for the suspension to take effect.
+ * @details The invoking thread sleeps until the end of transfer interrupt,
+ *          on timeout the SPI is forced idle by a disable/enable cycle.
+ * @note    Must be invoked from thread context within a critical zone.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ */
+static void spi_lld_suspend_s(SPIDriver *spip) {
+  msg_t msg;
+
+  spip->spi->CR1 |= SPI_CR1_CSUSP;
+  if ((spip->spi->CR1 & SPI_CR1_CSTART) == 0U) {
+    return;
+  }
+
+  spip->spi->IER |= SPI_IER_EOTIE;
+  msg = osalThreadSuspendTimeoutS(&spip->eot_thread,
+                                  OSAL_MS2I(STM32_SPI_EOT_TIMEOUT));
+  if (msg == MSG_TIMEOUT) {
+    spip->spi->IER &= ~SPI_IER_EOTIE;
+    spi_lld_config(spip);
+  }
+}
+
+/**
+ * @brief   Exchanges a small block through the SPI FIFO.
+ * @details The whole transfer is preloaded in the TX FIFO using packed word
+ *          accesses, then the RX FIFO is drained the same way. The SPI is
+ *          suspended at the end and the operation is completed by the end
+ *          of transfer interrupt as for the DMA path.
+ * @pre     The transfer fits in the SPI FIFO and the SPI is idle.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] nbytes    number of bytes to be exchanged
+ * @param[in] width     log2 of the frame size in bytes
+ * @param[in] txbuf     the pointer to the transmit buffer or @p NULL
+ * @param[out] rxbuf    the pointer to the receive buffer or @p NULL
+ */
+static void spi_lld_polled_transfer(SPIDriver *spip, size_t nbytes,
+                                    uint32_t width,
+                                    const void *txbuf, void *rxbuf) {
+  const uint8_t *tp = (const uint8_t *)txbuf;
+  uint8_t *rp = (uint8_t *)rxbuf;
+  size_t n;
+
+  spi_lld_wait_complete(spip);
+
+  /* Preloading, the FIFO is empty and large enough for the whole transfer
+     so TXP does not need to be checked.*/
+  for (n = nbytes; n >= 4U; n -= 4U) {
+    if (tp != NULL) {
+      spip->spi->TXDR = __UNALIGNED_UINT32_READ(tp);
+      tp += 4;
+    }
+    else {
+      spip->spi->TXDR = dummytx;
+    }
+  }
+  for (; n > 0U; n -= (size_t)1U << width) {
+    if (width == 0U) {
+      *(volatile uint8_t *)&spip->spi->TXDR = tp != NULL ? *tp++ :
+                                                           (uint8_t)dummytx;
+    }
+    else {
+      *(volatile uint16_t *)&spip->spi->TXDR =
+          tp != NULL ? __UNALIGNED_UINT16_READ(tp) : (uint16_t)dummytx;
+      tp = tp != NULL ? tp + 2 : NULL;
+    }
+  }
+
+  spip->spi->CR1 |= SPI_CR1_CSTART;
+
+  /* Draining, words first then the remaining frames.*/
+  for (n = nbytes; n >= 4U; n -= 4U) {
+    uint32_t w;
+
+    while ((spip->spi->SR & SPI_SR_RXWNE) == 0U) {
+    }
+    w = spip->spi->RXDR;
+    if (rp != NULL) {
+      __UNALIGNED_UINT32_WRITE(rp, w);
+      rp += 4;
+    }
+  }
+  for (; n > 0U; n -= (size_t)1U << width) {
+    while ((spip->spi->SR & SPI_SR_RXP) == 0U) {
+    }
+    if (width == 0U) {
+      uint8_t b = *(volatile uint8_t *)&spip->spi->RXDR;
+
+      if (rp != NULL) {
+        *rp++ = b;
+      }
+    }
+    else {
+      uint16_t h = *(volatile uint16_t *)&spip->spi->RXDR;
+
+      if (rp != NULL) {
+        __UNALIGNED_UINT16_WRITE(rp, h);
+        rp += 2;
+      }
+    }
+  }
+
+  /* All frames received, the suspension takes effect immediately and the
+     latched SUSP flag triggers the completion interrupt.*/
+  spip->spi->CR1 |= SPI_CR1_CSUSP;
+#if STM32_SPI_USE_STATISTICS == TRUE
+  spip->eot_start = DWT->CYCCNT;
+#endif
+  spip->spi->IER |= SPI_IER_EOTIE;
+}
+
+/**
+ * @brief   Selects the polled path for small transfers.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames to be exchanged
+ * @param[out] widthp   log2 of the frame size in bytes
+ * @return              The transfer size in bytes if the polled path has
+ *                      to be used, zero otherwise.
+ */
+static size_t spi_lld_polled_size(SPIDriver *spip, size_t n,
+                                  uint32_t *widthp) {
+  uint32_t dsize = (spip->spi->CFG1 & SPI_CFG1_DSIZE_Msk) + 1U;
+  uint32_t width = dsize <= 8U ? 0U : (dsize <= 16U ? 1U : 2U);
+
+  /* The threshold can be changed at runtime, the FIFO must still be able
+     to hold the whole transfer.*/
+#if STM32_SPI_USE_SPI3
+  osalDbgAssert(spip->polled_threshold <=
+                (spip == &SPID3 ? (size_t)STM32_SPI_FIFO_SIZE_LIMITED :
+                                  (size_t)STM32_SPI_FIFO_SIZE),
+                "threshold exceeds FIFO");
+#else
+  osalDbgAssert(spip->polled_threshold <= (size_t)STM32_SPI_FIFO_SIZE,
+                "threshold exceeds FIFO");
+#endif
+
+  *widthp = width;
+  return (n << width) <= spip->polled_threshold ? n << width : 0U;
+}
+#endif
 
 #if defined(STM32_SPI_BDMA_REQUIRED)
 /**
@@ -145,6 +306,182 @@ static void spi_lld_serve_bdma_tx_interrupt(SPIDriver *spip, uint32_t flags) {
 }
 #endif /* defined(STM32_SPI_BDMA_REQUIRED) */
 
+#if (STM32_SPI_USE_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Stream end-of-node service routine.
+ * @details A transfer complete event is raised at the end of each node, the
+ *          node loaded by the DMA tells which buffer half is in progress.
+ *          The callback is invoked once per half even if events coalesce.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void spi_lld_serve_stream_interrupt(SPIDriver *spip, uint32_t flags) {
+  const stm32_dma_lli_t *next;
+  size_t current;
+  bool second;
+
+  if ((flags & DMA_CSR_TCF) == 0U) {
+    return;
+  }
+
+  /* The link register already points to the node after the running one.*/
+  next = dmaStreamGetNextLink(spip->rx.dma);
+  osalDbgAssert(next != NULL, "stream chain broken");
+  current = (size_t)(next - &spip->stream_rxlli[0]);
+  current = (current + spip->stream_nodes - 1U) % spip->stream_nodes;
+
+  second = (bool)(current >= spip->stream_half);
+  if (second != spip->stream_second) {
+    spip->stream_second = second;
+    spip->stream_cb(spip, second ? SPI_STREAM_HALF : SPI_STREAM_FULL);
+  }
+}
+
+/**
+ * @brief   Stops the running stream.
+ * @details The SPI is suspended at the end of the current frame, the DMA
+ *          channels are returned to plain block transfers and the driver
+ *          goes back to the @p SPI_READY state.
+ * @note    Must be invoked from thread context within a critical zone.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ */
+static void spi_lld_stream_stop_s(SPIDriver *spip) {
+
+  spi_lld_suspend_s(spip);
+
+  dmaStreamDisable(spip->tx.dma);
+  dmaStreamDisable(spip->rx.dma);
+  spip->stream_cb = NULL;
+  spip->state     = SPI_READY;
+
+  /* Restoring plain block transfers for the one-shot operations.*/
+  spip->rx.dma->stream->CLLR  = 0U;
+  spip->rx.dma->stream->CTR1  = 0U;
+  spip->rx.dma->stream->CTR2 &= ~DMA_CTR2_TCEM_Msk;
+  spip->tx.dma->stream->CLLR  = 0U;
+  spip->tx.dma->stream->CTR1  = 0U;
+  spip->tx.dma->stream->CTR2 &= ~DMA_CTR2_TCEM_Msk;
+}
+#endif /* STM32_SPI_USE_STREAM == TRUE */
+
+#if (STM32_SPI_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the transaction at the head of the queue.
+ * @details The SPI is disabled for the time needed to load the frames count
+ *          in TSIZE and, if changed, the configuration registers. The SPI
+ *          then ends the transfer and releases the hardware NSS by itself.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ */
+static void spi_lld_queue_start(SPIDriver *spip) {
+  const spi_transaction_t *tp = spip->queue_head;
+  const SPIConfig *cfgp = tp->config != NULL ? tp->config : spip->config;
+  uint32_t dsize, width, ctr1;
+
+  dsize = (cfgp->cfg1 & SPI_CFG1_DSIZE_Msk) + 1U;
+  width = dsize <= 8U ? 0U : (dsize <= 16U ? 1U : 2U);
+  ctr1  = (width << DMA_CTR1_SDW_LOG2_Pos) | (width << DMA_CTR1_DDW_LOG2_Pos);
+
+  osalDbgAssert((tp->n << width) <= STM32_DMA_MAX_TRANSFER,
+                "unsupported DMA transfer size");
+
+  /* CFG1, CFG2 and TSIZE can only be written with the SPI disabled.*/
+  spip->spi->CR1 &= ~SPI_CR1_SPE;
+  if (cfgp != spip->queue_config) {
+    spip->spi->CFG1 = (cfgp->cfg1 & ~SPI_CFG1_FTHLV_Msk) |
+                      SPI_CFG1_RXDMAEN | SPI_CFG1_TXDMAEN;
+    spip->spi->CFG2 = (cfgp->cfg2 | SPI_CFG2_MASTER | SPI_CFG2_SSOE) &
+                      ~SPI_CFG2_COMM_Msk;
+    spip->queue_config = cfgp;
+  }
+  spip->spi->CR2  = (uint32_t)tp->n;
+  spip->spi->IFCR = 0xFFFFFFFFU;
+  spip->spi->CR1 |= SPI_CR1_SPE;
+
+  if (tp->cs != PAL_NOLINE) {
+    palClearLine(tp->cs);
+  }
+
+  /* Single block on both channels, the channels disable themselves at the
+     end of the block.*/
+  spip->rx.dma->stream->CFCR = STM32_DMA_ISR_MASK;
+  spip->rx.dma->stream->CLLR = 0U;
+  spip->rx.dma->stream->CTR1 = ctr1 | (tp->rxbuf != NULL ? DMA_CTR1_DINC : 0U);
+  spip->rx.dma->stream->CTR2 = dmaStreamGetRequestSource(spip->rx.dma) &
+                               ~(DMA_CTR2_SWREQ | DMA_CTR2_DREQ);
+  spip->rx.dma->stream->CBR1 = (uint32_t)(tp->n << width);
+  spip->rx.dma->stream->CSAR = (uint32_t)&spip->spi->RXDR;
+  spip->rx.dma->stream->CDAR = tp->rxbuf != NULL ? (uint32_t)tp->rxbuf :
+                                                   (uint32_t)&dummyrx;
+  spip->rx.dma->stream->CCR  = (spip->rx.dma->stream->CCR &
+                                ~STM32_DMA_ISR_MASK) |
+                               DMA_CCR_TCIE  | DMA_CCR_DTEIE |
+                               DMA_CCR_ULEIE | DMA_CCR_USEIE | DMA_CCR_EN;
+
+  spip->tx.dma->stream->CFCR = STM32_DMA_ISR_MASK;
+  spip->tx.dma->stream->CLLR = 0U;
+  spip->tx.dma->stream->CTR1 = ctr1 | (tp->txbuf != NULL ? DMA_CTR1_SINC : 0U);
+  spip->tx.dma->stream->CTR2 = (dmaStreamGetRequestSource(spip->tx.dma) &
+                                ~DMA_CTR2_SWREQ) | DMA_CTR2_DREQ;
+  spip->tx.dma->stream->CBR1 = (uint32_t)(tp->n << width);
+  spip->tx.dma->stream->CSAR = tp->txbuf != NULL ? (uint32_t)tp->txbuf :
+                                                   (uint32_t)&dummytx;
+  spip->tx.dma->stream->CDAR = (uint32_t)&spip->spi->TXDR;
+  spip->tx.dma->stream->CCR  = (spip->tx.dma->stream->CCR &
+                                ~STM32_DMA_ISR_MASK) |
+                               DMA_CCR_DTEIE | DMA_CCR_ULEIE |
+                               DMA_CCR_USEIE | DMA_CCR_EN;
+
+  spip->spi->CR1 |= SPI_CR1_CSTART;
+}
+
+/**
+ * @brief   Transaction end service routine.
+ * @details The next transaction is started before invoking the callback of
+ *          the completed one in order to keep the bus busy. When the queue
+ *          becomes empty the driver configuration is restored.
+ * @note    The callback is invoked with the system locked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void spi_lld_serve_queue_interrupt(SPIDriver *spip, uint32_t flags) {
+  spi_transaction_t *tp;
+
+  if ((flags & DMA_CSR_TCF) == 0U) {
+    return;
+  }
+
+  osalSysLockFromISR();
+  tp = spip->queue_head;
+
+  /* The receiver completes last, all the TSIZE frames have been exchanged.*/
+  if (tp->cs != PAL_NOLINE) {
+    palSetLine(tp->cs);
+  }
+
+  spip->queue_head = tp->next;
+  if (spip->queue_head != NULL) {
+    spi_lld_queue_start(spip);
+  }
+  else {
+    spip->queue_tail   = NULL;
+    spip->queue_config = NULL;
+    spip->rx.dma->stream->CTR1 = 0U;
+    spip->tx.dma->stream->CTR1 = 0U;
+    spi_lld_config(spip);
+    spip->state = SPI_READY;
+  }
+
+  if (tp->cb != NULL) {
+    tp->cb(spip, tp);
+  }
+  osalSysUnlockFromISR();
+}
+#endif /* STM32_SPI_USE_QUEUE == TRUE */
+
 #if defined(STM32_SPI_DMA_REQUIRED)
 /**
  * @brief   Shared DMA end-of-rx service routine.
@@ -166,6 +503,19 @@ static void spi_lld_serve_dma_rx_interrupt(SPIDriver *spip, uint32_t flags) {
 #else
   (void)flags;
 #endif
+#if STM32_SPI_USE_STREAM == TRUE
+  if (spip->stream_cb != NULL) {
+    /* Streaming, the DMA keeps running on the circular chain.*/
+    spi_lld_serve_stream_interrupt(spip, flags);
+    return;
+  }
+#endif
+#if STM32_SPI_USE_QUEUE == TRUE
+  if (spip->queue_head != NULL) {
+    spi_lld_serve_queue_interrupt(spip, flags);
+    return;
+  }
+#endif
 #if !defined(STM32U5) // STM32U5 PORT
   if (spip->config->circular) {
     if ((flags & STM32_DMA_ISR_HTIF) != 0U) {
@@ -188,9 +538,18 @@ static void spi_lld_serve_dma_rx_interrupt(SPIDriver *spip, uint32_t flags) {
     dmaStreamDisable(spip->tx.dma);
     dmaStreamDisable(spip->rx.dma);
 
+#if !defined(STM32U5) // STM32U5 PORT
     /* Portable SPI ISR code defined in the high level driver, note, it is
        a macro.*/
     _spi_isr_code(spip);
+#else
+    /* The operation is completed by the SPI interrupt once the suspension
+       has taken effect, a latched SUSP flag triggers it immediately.*/
+#if STM32_SPI_USE_STATISTICS == TRUE
+    spip->eot_start = DWT->CYCCNT;
+#endif
+    spip->spi->IER |= SPI_IER_EOTIE;
+#endif
   }
 }
 
@@ -225,14 +584,49 @@ static void spi_lld_serve_dma_tx_interrupt(SPIDriver *spip, uint32_t flags) {
  * @param[in] spip      pointer to the @p SPIDriver object
  */
 static void spi_lld_serve_interrupt(SPIDriver *spip) {
-  uint32_t sr;
+  uint32_t sr, ier;
 
-  sr = spip->spi->SR & spip->spi->IER;
-  spip->spi->IFCR = sr;
+  /* SR is sampled once, the flags cleared below are still tested on the
+     sampled value.*/
+  ier = spip->spi->IER;
+  sr  = spip->spi->SR;
+  spip->spi->IFCR = sr & ier;
 
-  if ((sr & SPI_SR_OVR) != 0U) {
+  if ((sr & ier & SPI_SR_OVR) != 0U) {
     /* CHTODO: fault notification.*/
   }
+
+#if defined(STM32U5) // STM32U5 PORT
+  /* EOTIE enables both the EOT and SUSP sources, SUSP is not in the IER
+     layout so the flags are checked separately.*/
+  if (((ier & SPI_IER_EOTIE) != 0U) &&
+      ((sr & (SPI_SR_EOT | SPI_SR_SUSP)) != 0U)) {
+    spip->spi->IER &= ~SPI_IER_EOTIE;
+    spip->spi->IFCR = SPI_IFCR_EOTC | SPI_IFCR_SUSPC;
+
+    if (spip->eot_thread != NULL) {
+      /* A thread is waiting for a suspend request to take effect.*/
+      osalSysLockFromISR();
+      osalThreadResumeI(&spip->eot_thread, MSG_OK);
+      osalSysUnlockFromISR();
+    }
+    else {
+#if STM32_SPI_USE_STATISTICS == TRUE
+      uint32_t cycles = DWT->CYCCNT - spip->eot_start;
+
+      spip->stats.transfers++;
+      spip->stats.last   = cycles;
+      spip->stats.total += cycles;
+      if (cycles > spip->stats.max) {
+        spip->stats.max = cycles;
+      }
+#endif
+      /* Portable SPI ISR code defined in the high level driver, note, it
+         is a macro.*/
+      _spi_isr_code(spip);
+    }
+  }
+#endif
 }
 
 /*===========================================================================*/
@@ -534,6 +928,17 @@ void spi_lld_start(SPIDriver *spip) {
 
   /* If in stopped state then enables the SPI and DMA clocks.*/
   if (spip->state == SPI_STOP) {
+#if defined(STM32U5) // STM32U5 PORT
+    spip->eot_thread = NULL;
+#endif
+#if STM32_SPI_USE_STREAM == TRUE
+    spip->stream_cb = NULL;
+#endif
+#if STM32_SPI_USE_QUEUE == TRUE
+    spip->queue_head   = NULL;
+    spip->queue_tail   = NULL;
+    spip->queue_config = NULL;
+#endif
 #if STM32_SPI_USE_SPI1
     if (&SPID1 == spip) {
       spip->rx.dma = dmaStreamAllocI(STM32_SPI_SPI1_RX_DMA_STREAM,
@@ -555,6 +960,7 @@ void spi_lld_start(SPIDriver *spip) {
       spip->rx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI1_RX ;
       spip->tx.dma->stream->CTR2 &= ~DMA_CTR2_REQSEL_Msk ;
       spip->tx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI1_TX ;
+      spip->polled_threshold = STM32_SPI_SPI1_POLLED_THRESHOLD;
 #endif
     }
 #endif
@@ -579,6 +985,7 @@ void spi_lld_start(SPIDriver *spip) {
       spip->rx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI2_RX ;
       spip->tx.dma->stream->CTR2 &= ~DMA_CTR2_REQSEL_Msk ;
       spip->tx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI2_TX ;
+      spip->polled_threshold = STM32_SPI_SPI2_POLLED_THRESHOLD;
 #endif
     }
 #endif
@@ -603,6 +1010,7 @@ void spi_lld_start(SPIDriver *spip) {
       spip->rx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI3_RX ;
       spip->tx.dma->stream->CTR2 &= ~DMA_CTR2_REQSEL_Msk ;
       spip->tx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI3_TX ;
+      spip->polled_threshold = STM32_SPI_SPI3_POLLED_THRESHOLD;
 #endif
     }
 #endif
@@ -627,6 +1035,7 @@ void spi_lld_start(SPIDriver *spip) {
       spip->rx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI4_RX ;
       spip->tx.dma->stream->CTR2 &= ~DMA_CTR2_REQSEL_Msk ;
       spip->tx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI4_TX ;
+      spip->polled_threshold = STM32_SPI_SPI4_POLLED_THRESHOLD;
 #endif
     }
 #endif
@@ -651,6 +1060,7 @@ void spi_lld_start(SPIDriver *spip) {
       spip->rx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI5_RX ;
       spip->tx.dma->stream->CTR2 &= ~DMA_CTR2_REQSEL_Msk ;
       spip->tx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI5_TX ;
+      spip->polled_threshold = STM32_SPI_SPI5_POLLED_THRESHOLD;
 #endif
     }
 #endif
@@ -675,6 +1085,7 @@ void spi_lld_start(SPIDriver *spip) {
       spip->rx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI6_RX ;
       spip->tx.dma->stream->CTR2 &= ~DMA_CTR2_REQSEL_Msk ;
       spip->tx.dma->stream->CTR2 |= STM32_DMAMUX1_SPI6_TX ;
+      spip->polled_threshold = STM32_SPI_SPI6_POLLED_THRESHOLD;
 #endif
     }
 #endif
@@ -821,6 +1232,14 @@ void spi_lld_config(SPIDriver *spip) {
  */
 void spi_lld_stop(SPIDriver *spip) {
 
+#if STM32_SPI_USE_STREAM == TRUE
+  /* A running stream is stopped first, the DMA channels must not be left
+     with a linked list loaded.*/
+  if (spip->stream_cb != NULL) {
+    spi_lld_stream_stop_s(spip);
+  }
+#endif
+
   /* If in ready state then disables the SPI clock.*/
   if (spip->state == SPI_READY) {
 
@@ -919,6 +1338,18 @@ void spi_lld_ignore(SPIDriver *spip, size_t n) {
 
   osalDbgAssert(n < 65536, "unsupported DMA transfer size");
 
+#if defined(STM32U5) // STM32U5 PORT
+  {
+    uint32_t width;
+    size_t nbytes = spi_lld_polled_size(spip, n, &width);
+
+    if (nbytes > 0U) {
+      spi_lld_polled_transfer(spip, nbytes, width, NULL, NULL);
+      return;
+    }
+  }
+#endif
+
 #if !defined(STM32U5) // STM32U5 PORT
   spi_lld_wait_complete(spip);
 #endif
@@ -981,6 +1412,18 @@ void spi_lld_exchange(SPIDriver *spip, size_t n,
 
   osalDbgAssert(n <= STM32_DMA_MAX_TRANSFER, "unsupported DMA transfer size");
 
+#if defined(STM32U5) // STM32U5 PORT
+  {
+    uint32_t width;
+    size_t nbytes = spi_lld_polled_size(spip, n, &width);
+
+    if (nbytes > 0U) {
+      spi_lld_polled_transfer(spip, nbytes, width, txbuf, rxbuf);
+      return;
+    }
+  }
+#endif
+
   spi_lld_wait_complete(spip);
 
 #if defined(STM32_SPI_DMA_REQUIRED) && defined(STM32_SPI_BDMA_REQUIRED)
@@ -1061,6 +1504,18 @@ void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
 
   osalDbgAssert(n <= STM32_DMA_MAX_TRANSFER, "unsupported DMA transfer size");
 
+#if defined(STM32U5) // STM32U5 PORT
+  {
+    uint32_t width;
+    size_t nbytes = spi_lld_polled_size(spip, n, &width);
+
+    if (nbytes > 0U) {
+      spi_lld_polled_transfer(spip, nbytes, width, txbuf, NULL);
+      return;
+    }
+  }
+#endif
+
   spi_lld_wait_complete(spip);
 
 #if defined(STM32_SPI_DMA_REQUIRED) && defined(STM32_SPI_BDMA_REQUIRED)
@@ -1141,6 +1596,18 @@ void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
 
   osalDbgAssert(n <= STM32_DMA_MAX_TRANSFER, "unsupported DMA transfer size");
 
+#if defined(STM32U5) // STM32U5 PORT
+  {
+    uint32_t width;
+    size_t nbytes = spi_lld_polled_size(spip, n, &width);
+
+    if (nbytes > 0U) {
+      spi_lld_polled_transfer(spip, nbytes, width, NULL, rxbuf);
+      return;
+    }
+  }
+#endif
+
   spi_lld_wait_complete(spip);
 
 #if defined(STM32_SPI_DMA_REQUIRED) && defined(STM32_SPI_BDMA_REQUIRED)
@@ -1296,10 +1763,201 @@ uint32_t spi_lld_polled_exchange(SPIDriver *spip, uint32_t frame) {
   }
 
   spip->spi->CR1 |= SPI_CR1_CSUSP;
+#if defined(STM32U5) // STM32U5 PORT
+  /* The frame has already been received, the suspension takes effect
+     immediately and the SPI is left idle for the next operation.*/
+  while ((spip->spi->CR1 & SPI_CR1_CSTART) != 0U) {
+  }
+#endif
 
   return rxframe;
 }
 
+#if (STM32_SPI_USE_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a continuous stream.
+ * @details The transmitter and the receiver run on circular GPDMA linked
+ *          lists over @p txbuf and @p rxbuf, the SPI is started once and
+ *          clocks without gaps until @p spiSTM32StopStream() is invoked.
+ *          Each buffer half is split in as many nodes as required so the
+ *          buffer size is not limited by @p STM32_DMA_MAX_TRANSFER. The
+ *          callback is invoked each time a half has been exchanged.
+ * @note    The driver stays in the @p SPI_ACTIVE state while streaming.
+ * @note    The buffers are organized as uint8_t arrays for data sizes below
+ *          or equal to 8 bits, uint16_t arrays up to 16 bits else uint32_t
+ *          arrays.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         buffers size in frames, must be even
+ * @param[in] txbuf     the pointer to the transmit buffer or @p NULL if the
+ *                      filler pattern has to be sent
+ * @param[out] rxbuf    the pointer to the receive buffer or @p NULL if the
+ *                      received data has to be discarded
+ * @param[in] cb        stream events callback
+ *
+ * @api
+ */
+void spiSTM32StartStream(SPIDriver *spip, size_t n,
+                         const void *txbuf, void *rxbuf,
+                         spistreamcb_t cb) {
+  uint32_t dsize, width, ctr1;
+  size_t fsize, maxn, half, node, i;
+
+  osalDbgCheck((spip != NULL) && (cb != NULL) &&
+               (n >= 2U) && ((n & 1U) == 0U));
+
+  dsize = (spip->config->cfg1 & SPI_CFG1_DSIZE_Msk) + 1U;
+  width = dsize <= 8U ? 0U : (dsize <= 16U ? 1U : 2U);
+  fsize = (size_t)1U << width;
+  maxn  = STM32_DMA_MAX_TRANSFER / fsize;
+  half  = n / 2U;
+
+  osalDbgAssert((half + maxn - 1U) / maxn <= STM32_SPI_STREAM_NODES / 2U,
+                "stream buffer too large");
+  osalDbgAssert((((uint32_t)txbuf | (uint32_t)rxbuf) & (fsize - 1U)) == 0U,
+                "unaligned buffer");
+
+  osalSysLock();
+  osalDbgAssert(spip->state == SPI_READY, "not ready");
+
+  spi_lld_wait_complete(spip);
+
+  /* Building both chains, each half starts on a node boundary.*/
+  ctr1 = (width << DMA_CTR1_SDW_LOG2_Pos) | (width << DMA_CTR1_DDW_LOG2_Pos);
+  node = 0U;
+  for (i = 0U; i < 2U; i++) {
+    size_t offset = i * half * fsize;
+    size_t left   = half;
+
+    if (i == 1U) {
+      spip->stream_half = node;
+    }
+    while (left > 0U) {
+      size_t chunk = left < maxn ? left : maxn;
+
+      dmaLliObjectInit(&spip->stream_rxlli[node],
+                       ctr1 | (rxbuf != NULL ? DMA_CTR1_DINC : 0U),
+                       (dmaStreamGetRequestSource(spip->rx.dma) &
+                        ~(DMA_CTR2_SWREQ | DMA_CTR2_DREQ)) |
+                       STM32_DMA_CTR2_TCEM_LLI,
+                       &spip->spi->RXDR,
+                       rxbuf != NULL ? (uint8_t *)rxbuf + offset :
+                                       (void *)&dummyrx,
+                       chunk * fsize);
+      dmaLliObjectInit(&spip->stream_txlli[node],
+                       ctr1 | (txbuf != NULL ? DMA_CTR1_SINC : 0U),
+                       (dmaStreamGetRequestSource(spip->tx.dma) &
+                        ~DMA_CTR2_SWREQ) | DMA_CTR2_DREQ,
+                       txbuf != NULL ? (const uint8_t *)txbuf + offset :
+                                       (const void *)&dummytx,
+                       &spip->spi->TXDR,
+                       chunk * fsize);
+      offset += chunk * fsize;
+      left   -= chunk;
+      node++;
+    }
+  }
+  for (i = 0U; i < node; i++) {
+    dmaLliLink(&spip->stream_rxlli[i], &spip->stream_rxlli[(i + 1U) % node]);
+    dmaLliLink(&spip->stream_txlli[i], &spip->stream_txlli[(i + 1U) % node]);
+  }
+  spip->stream_nodes  = node;
+  spip->stream_second = false;
+  spip->stream_cb     = cb;
+  spip->state         = SPI_ACTIVE;
+
+  /* Only the receiver generates events, it is the last to complete.*/
+  dmaStreamDisable(spip->rx.dma);
+  dmaStreamDisable(spip->tx.dma);
+  dmaStreamStartLinkedListI(spip->rx.dma, &spip->stream_rxlli[0],
+                            DMA_CCR_TCIE  | DMA_CCR_DTEIE |
+                            DMA_CCR_ULEIE | DMA_CCR_USEIE);
+  dmaStreamStartLinkedListI(spip->tx.dma, &spip->stream_txlli[0],
+                            DMA_CCR_DTEIE | DMA_CCR_ULEIE | DMA_CCR_USEIE);
+
+  spip->spi->CR1 |= SPI_CR1_CSTART;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops a continuous stream.
+ * @details The SPI is suspended at the end of the current frame and the
+ *          driver goes back to the @p SPI_READY state.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @api
+ */
+void spiSTM32StopStream(SPIDriver *spip) {
+
+  osalDbgCheck(spip != NULL);
+
+  osalSysLock();
+  if (spip->stream_cb != NULL) {
+    spi_lld_stream_stop_s(spip);
+  }
+  osalSysUnlock();
+}
+#endif /* STM32_SPI_USE_STREAM == TRUE */
+
+#if (STM32_SPI_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Queues a transaction.
+ * @details If the queue is idle the transaction is started immediately,
+ *          else it is started from the completion interrupt of the previous
+ *          one without thread intervention. The chip select line is asserted
+ *          at start and released at the end of each transaction.
+ * @note    The driver stays in the @p SPI_ACTIVE state until the queue
+ *          becomes empty.
+ * @note    The buffers are organized as uint8_t arrays for data sizes below
+ *          or equal to 8 bits, uint16_t arrays up to 16 bits else uint32_t
+ *          arrays.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] tp        pointer to the transaction descriptor
+ *
+ * @iclass
+ */
+void spiSTM32QueueTransactionI(SPIDriver *spip, spi_transaction_t *tp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((spip != NULL) && (tp != NULL) &&
+               (tp->n > 0U) &&
+               (tp->n <= (SPI_CR2_TSIZE_Msk >> SPI_CR2_TSIZE_Pos)));
+
+  tp->next = NULL;
+  if (spip->queue_head == NULL) {
+    osalDbgAssert(spip->state == SPI_READY, "not ready");
+
+    spip->queue_head = tp;
+    spip->queue_tail = tp;
+    spip->state      = SPI_ACTIVE;
+    spi_lld_wait_complete(spip);
+    spi_lld_queue_start(spip);
+  }
+  else {
+    spip->queue_tail->next = tp;
+    spip->queue_tail       = tp;
+  }
+}
+
+/**
+ * @brief   Queues a transaction.
+ * @details See @p spiSTM32QueueTransactionI().
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] tp        pointer to the transaction descriptor
+ *
+ * @api
+ */
+void spiSTM32QueueTransaction(SPIDriver *spip, spi_transaction_t *tp) {
+
+  osalSysLock();
+  spiSTM32QueueTransactionI(spip, tp);
+  osalSysUnlock();
+}
+#endif /* STM32_SPI_USE_QUEUE == TRUE */
+
 #endif /* HAL_USE_SPI */
 
 /** @} */
@@ -236,12 +236,137 @@
 #define STM32_SPI_SPI6_DMA_PRIORITY         1
 #endif
 
+/**
+ * @brief   SPI1 polled transfer threshold in bytes.
+ * @details Transfers up to this size are exchanged through the SPI FIFO by
+ *          the CPU instead of programming the DMA.
+ * @note    If set to zero then the DMA is always used.
+ * @note    The FIFO is busy-waited with the system locked, the threshold
+ *          sets the longest time interrupts are masked by a transfer.
+ */
+#if !defined(STM32_SPI_SPI1_POLLED_THRESHOLD) || defined(__DOXYGEN__)
+#define STM32_SPI_SPI1_POLLED_THRESHOLD     0
+#endif
+
+/**
+ * @brief   SPI2 polled transfer threshold in bytes.
+ * @details Transfers up to this size are exchanged through the SPI FIFO by
+ *          the CPU instead of programming the DMA.
+ * @note    If set to zero then the DMA is always used.
+ * @note    The FIFO is busy-waited with the system locked, the threshold
+ *          sets the longest time interrupts are masked by a transfer.
+ */
+#if !defined(STM32_SPI_SPI2_POLLED_THRESHOLD) || defined(__DOXYGEN__)
+#define STM32_SPI_SPI2_POLLED_THRESHOLD     0
+#endif
+
+/**
+ * @brief   SPI3 polled transfer threshold in bytes.
+ * @details Transfers up to this size are exchanged through the SPI FIFO by
+ *          the CPU instead of programming the DMA.
+ * @note    If set to zero then the DMA is always used.
+ * @note    The FIFO is busy-waited with the system locked, the threshold
+ *          sets the longest time interrupts are masked by a transfer.
+ */
+#if !defined(STM32_SPI_SPI3_POLLED_THRESHOLD) || defined(__DOXYGEN__)
+#define STM32_SPI_SPI3_POLLED_THRESHOLD     0
+#endif
+
+/**
+ * @brief   SPI4 polled transfer threshold in bytes.
+ * @details Transfers up to this size are exchanged through the SPI FIFO by
+ *          the CPU instead of programming the DMA.
+ * @note    If set to zero then the DMA is always used.
+ * @note    The FIFO is busy-waited with the system locked, the threshold
+ *          sets the longest time interrupts are masked by a transfer.
+ */
+#if !defined(STM32_SPI_SPI4_POLLED_THRESHOLD) || defined(__DOXYGEN__)
+#define STM32_SPI_SPI4_POLLED_THRESHOLD     0
+#endif
+
+/**
+ * @brief   SPI5 polled transfer threshold in bytes.
+ * @details Transfers up to this size are exchanged through the SPI FIFO by
+ *          the CPU instead of programming the DMA.
+ * @note    If set to zero then the DMA is always used.
+ * @note    The FIFO is busy-waited with the system locked, the threshold
+ *          sets the longest time interrupts are masked by a transfer.
+ */
+#if !defined(STM32_SPI_SPI5_POLLED_THRESHOLD) || defined(__DOXYGEN__)
+#define STM32_SPI_SPI5_POLLED_THRESHOLD     0
+#endif
+
+/**
+ * @brief   SPI6 polled transfer threshold in bytes.
+ * @details Transfers up to this size are exchanged through the SPI FIFO by
+ *          the CPU instead of programming the DMA.
+ * @note    If set to zero then the DMA is always used.
+ * @note    The FIFO is busy-waited with the system locked, the threshold
+ *          sets the longest time interrupts are masked by a transfer.
+ */
+#if !defined(STM32_SPI_SPI6_POLLED_THRESHOLD) || defined(__DOXYGEN__)
+#define STM32_SPI_SPI6_POLLED_THRESHOLD     0
+#endif
+
 /**
  * @brief   SPI DMA error hook.
  */
 #if !defined(STM32_SPI_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
 #define STM32_SPI_DMA_ERROR_HOOK(spip)      osalSysHalt("DMA failure")
 #endif
+
+/**
+ * @brief   SPI end of transfer timeout in milliseconds.
+ * @details Maximum time a thread waits for a suspend request to take
+ *          effect, on timeout the SPI is forcibly disabled.
+ */
+#if !defined(STM32_SPI_EOT_TIMEOUT) || defined(__DOXYGEN__)
+#define STM32_SPI_EOT_TIMEOUT               10
+#endif
+
+/**
+ * @brief   End of transfer statistics switch.
+ * @details If set to @p TRUE each driver measures, in DWT cycles, the time
+ *          between the end of the DMA and the SPI end of transfer
+ *          interrupt, see @p spistats_t.
+ * @note    The DWT cycle counter must be enabled by the application.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_SPI_USE_STATISTICS) || defined(__DOXYGEN__)
+#define STM32_SPI_USE_STATISTICS            FALSE
+#endif
+
+/**
+ * @brief   Continuous stream support.
+ * @details If set to @p TRUE the @p spiSTM32StartStream() API is included,
+ *          the transmitter and the receiver run on circular GPDMA linked
+ *          lists until the stream is stopped.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_SPI_USE_STREAM) || defined(__DOXYGEN__)
+#define STM32_SPI_USE_STREAM                FALSE
+#endif
+
+/**
+ * @brief   Number of linked-list nodes per stream direction.
+ * @details Each node moves up to @p STM32_DMA_MAX_TRANSFER bytes, this
+ *          setting limits the stream buffer size.
+ * @note    Must be an even number, each buffer half has its own nodes.
+ */
+#if !defined(STM32_SPI_STREAM_NODES) || defined(__DOXYGEN__)
+#define STM32_SPI_STREAM_NODES              4
+#endif
+
+/**
+ * @brief   Transaction queue support.
+ * @details If set to @p TRUE the @p spiSTM32QueueTransaction() API is
+ *          included, queued transactions are chained back to back from the
+ *          DMA completion interrupt.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_SPI_USE_QUEUE) || defined(__DOXYGEN__)
+#define STM32_SPI_USE_QUEUE                 FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -277,6 +402,75 @@
 #error "SPI driver activated but no SPI peripheral assigned"
 #endif
 
+/**
+ * @brief   SPI FIFO size in bytes.
+ */
+#define STM32_SPI_FIFO_SIZE                 16
+
+/**
+ * @brief   SPI FIFO size in bytes on the limited feature set instances.
+ */
+#if defined(STM32U5) || defined(__DOXYGEN__) // STM32U5 PORT
+#define STM32_SPI_FIFO_SIZE_LIMITED         8
+#else
+#define STM32_SPI_FIFO_SIZE_LIMITED         STM32_SPI_FIFO_SIZE
+#endif
+
+#if (STM32_SPI_SPI1_POLLED_THRESHOLD < 0) ||                                \
+    (STM32_SPI_SPI1_POLLED_THRESHOLD > STM32_SPI_FIFO_SIZE)
+#error "invalid STM32_SPI_SPI1_POLLED_THRESHOLD value"
+#endif
+
+#if (STM32_SPI_SPI2_POLLED_THRESHOLD < 0) ||                                \
+    (STM32_SPI_SPI2_POLLED_THRESHOLD > STM32_SPI_FIFO_SIZE)
+#error "invalid STM32_SPI_SPI2_POLLED_THRESHOLD value"
+#endif
+
+#if (STM32_SPI_SPI3_POLLED_THRESHOLD < 0) ||                                \
+    (STM32_SPI_SPI3_POLLED_THRESHOLD > STM32_SPI_FIFO_SIZE_LIMITED)
+#error "invalid STM32_SPI_SPI3_POLLED_THRESHOLD value"
+#endif
+
+#if (STM32_SPI_SPI4_POLLED_THRESHOLD < 0) ||                                \
+    (STM32_SPI_SPI4_POLLED_THRESHOLD > STM32_SPI_FIFO_SIZE)
+#error "invalid STM32_SPI_SPI4_POLLED_THRESHOLD value"
+#endif
+
+#if (STM32_SPI_SPI5_POLLED_THRESHOLD < 0) ||                                \
+    (STM32_SPI_SPI5_POLLED_THRESHOLD > STM32_SPI_FIFO_SIZE)
+#error "invalid STM32_SPI_SPI5_POLLED_THRESHOLD value"
+#endif
+
+#if (STM32_SPI_SPI6_POLLED_THRESHOLD < 0) ||                                \
+    (STM32_SPI_SPI6_POLLED_THRESHOLD > STM32_SPI_FIFO_SIZE)
+#error "invalid STM32_SPI_SPI6_POLLED_THRESHOLD value"
+#endif
+
+#if STM32_SPI_USE_STATISTICS && !defined(STM32U5)
+#error "STM32_SPI_USE_STATISTICS requires the STM32U5 SPI"
+#endif
+
+#if STM32_SPI_USE_STREAM && !defined(STM32U5)
+#error "STM32_SPI_USE_STREAM requires the GPDMA linked-list support"
+#endif
+
+#if STM32_SPI_USE_STREAM && STM32_SPI_USE_SPI6
+#error "STM32_SPI_USE_STREAM not supported on BDMA instances"
+#endif
+
+#if STM32_SPI_USE_STREAM &&                                                 \
+    ((STM32_SPI_STREAM_NODES < 2) || ((STM32_SPI_STREAM_NODES & 1) != 0))
+#error "invalid STM32_SPI_STREAM_NODES value"
+#endif
+
+#if STM32_SPI_USE_QUEUE && !defined(STM32U5)
+#error "STM32_SPI_USE_QUEUE requires the STM32U5 SPI"
+#endif
+
+#if STM32_SPI_USE_QUEUE && STM32_SPI_USE_SPI6
+#error "STM32_SPI_USE_QUEUE not supported on BDMA instances"
+#endif
+
 #if STM32_SPI_USE_SPI1 &&                                                   \
     !OSAL_IRQ_IS_VALID_PRIORITY(STM32_SPI_SPI1_IRQ_PRIORITY)
 #error "Invalid IRQ priority assigned to SPI1"
@@ -452,10 +646,171 @@
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
 
+#if (STM32_SPI_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   SPI driver end of transfer statistics.
+ * @details The cycles between the end of the DMA and the end of transfer
+ *          interrupt are the CPU time a thread would have spent polling the
+ *          SPI before starting the next operation.
+ */
+typedef struct {
+  /**
+   * @brief   Number of operations completed on end of transfer.
+   */
+  uint32_t                  transfers;
+  /**
+   * @brief   Cycles reclaimed by the last operation.
+   */
+  uint32_t                  last;
+  /**
+   * @brief   Maximum cycles reclaimed by a single operation.
+   */
+  uint32_t                  max;
+  /**
+   * @brief   Total cycles reclaimed.
+   */
+  uint64_t                  total;
+} spistats_t;
+#endif
+
+#if (STM32_SPI_USE_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @name    Stream events
+ * @{
+ */
+#define SPI_STREAM_HALF             1U  /**< @brief First half exchanged.   */
+#define SPI_STREAM_FULL             2U  /**< @brief Second half exchanged.  */
+/** @} */
+
+/**
+ * @brief   Stream SPI notification callback type.
+ * @details The half just exchanged can be refilled or consumed while the
+ *          DMA works on the other one.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] events    either @p SPI_STREAM_HALF or @p SPI_STREAM_FULL
+ */
+typedef void (*spistreamcb_t)(SPIDriver *spip, uint32_t events);
+#endif
+
+#if (STM32_SPI_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a queued SPI transaction.
+ */
+typedef struct spi_transaction spi_transaction_t;
+
+/**
+ * @brief   Transaction completion callback type.
+ * @note    The callback is invoked from ISR context with the system locked,
+ *          only I-class functions can be used.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] tp        pointer to the completed transaction, it can be
+ *                      queued again from within the callback
+ */
+typedef void (*spitransactioncb_t)(SPIDriver *spip, spi_transaction_t *tp);
+
+/**
+ * @brief   Queued SPI transaction descriptor.
+ * @note    The descriptor belongs to the driver from the moment it is
+ *          queued until its callback is invoked.
+ */
+struct spi_transaction {
+  /**
+   * @brief   Next queued transaction, managed by the driver.
+   */
+  spi_transaction_t         *next;
+  /**
+   * @brief   Chip select line, @p PAL_NOLINE if the hardware NSS output
+   *          of the SPI is used.
+   */
+  ioline_t                  cs;
+  /**
+   * @brief   Configuration override, @p NULL for the driver configuration.
+   * @note    Only the @p cfg1 and @p cfg2 fields are used.
+   */
+  const SPIConfig           *config;
+  /**
+   * @brief   Number of frames to be exchanged.
+   * @note    This is the SPI TSIZE value, the limit is 1023 frames on the
+   *          limited feature set instances.
+   */
+  size_t                    n;
+  /**
+   * @brief   Transmit buffer, @p NULL if the filler pattern is sent.
+   */
+  const void                *txbuf;
+  /**
+   * @brief   Receive buffer, @p NULL if the received data is discarded.
+   */
+  void                      *rxbuf;
+  /**
+   * @brief   Completion callback, can be @p NULL.
+   */
+  spitransactioncb_t        cb;
+};
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+#if defined(STM32U5) || defined(__DOXYGEN__) // STM32U5 PORT
+#if (STM32_SPI_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#define spi_lld_eot_fields                                                  \
+  /* Thread waiting for a suspend request to take effect.*/                 \
+  thread_reference_t        eot_thread;                                     \
+  /* DWT cycle counter at the end of the DMA.*/                             \
+  uint32_t                  eot_start;                                      \
+  /* End of transfer statistics.*/                                          \
+  spistats_t                stats;
+#else
+#define spi_lld_eot_fields                                                  \
+  /* Thread waiting for a suspend request to take effect.*/                 \
+  thread_reference_t        eot_thread;
+#endif
+#else
+#define spi_lld_eot_fields
+#endif
+
+#if defined(STM32U5) || defined(__DOXYGEN__) // STM32U5 PORT
+#define spi_lld_polled_fields                                               \
+  /* Transfers up to this size in bytes do not use the DMA.*/               \
+  size_t                    polled_threshold;
+#else
+#define spi_lld_polled_fields
+#endif
+
+#if (STM32_SPI_USE_STREAM == TRUE) || defined(__DOXYGEN__)
+#define spi_lld_stream_fields                                               \
+  /* Stream callback, @p NULL if not streaming.*/                           \
+  spistreamcb_t             stream_cb;                                      \
+  /* Number of nodes per direction in the running stream.*/                 \
+  size_t                    stream_nodes;                                   \
+  /* First node of the second buffer half.*/                                \
+  size_t                    stream_half;                                    \
+  /* The receive DMA is working on the second buffer half.*/                \
+  bool                      stream_second;                                  \
+  /* Circular chain feeding the receive buffer.*/                           \
+  stm32_dma_lli_t           stream_rxlli[STM32_SPI_STREAM_NODES];           \
+  /* Circular chain draining the transmit buffer.*/                         \
+  stm32_dma_lli_t           stream_txlli[STM32_SPI_STREAM_NODES];
+#else
+#define spi_lld_stream_fields
+#endif
+
+#if (STM32_SPI_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+#define spi_lld_queue_fields                                                \
+  /* Transaction in progress, @p NULL if the queue is idle.*/               \
+  spi_transaction_t         *queue_head;                                    \
+  /* Last queued transaction.*/                                             \
+  spi_transaction_t         *queue_tail;                                    \
+  /* Configuration currently loaded in CFG1 and CFG2.*/                     \
+  const SPIConfig           *queue_config;
+#else
+#define spi_lld_queue_fields
+#endif
+
 #if (defined(STM32_SPI_DMA_REQUIRED) &&                                     \
      defined(STM32_SPI_BDMA_REQUIRED)) || defined(__DOXYGEN__)
 #define spi_lld_driver_fields                                               \
@@ -487,6 +842,10 @@
 #define spi_lld_driver_fields                                               \
   /* Pointer to the SPIx registers block.*/                                 \
   SPI_TypeDef               *spi;                                           \
+  spi_lld_eot_fields                                                        \
+  spi_lld_polled_fields                                                     \
+  spi_lld_stream_fields                                                     \
+  spi_lld_queue_fields                                                      \
   /** Union of the RX DMA streams.*/                                        \
   union {                                                                   \
     /* Receive DMA stream.*/                                                \
@@ -580,6 +939,16 @@ extern "C" {
   void spi_lld_abort(SPIDriver *spip);
 #endif
   uint32_t spi_lld_polled_exchange(SPIDriver *spip, uint32_t frame);
+#if STM32_SPI_USE_STREAM == TRUE
+  void spiSTM32StartStream(SPIDriver *spip, size_t n,
+                           const void *txbuf, void *rxbuf,
+                           spistreamcb_t cb);
+  void spiSTM32StopStream(SPIDriver *spip);
+#endif
+#if STM32_SPI_USE_QUEUE == TRUE
+  void spiSTM32QueueTransactionI(SPIDriver *spip, spi_transaction_t *tp);
+  void spiSTM32QueueTransaction(SPIDriver *spip, spi_transaction_t *tp);
+#endif
 #ifdef __cplusplus
 }
 #endif
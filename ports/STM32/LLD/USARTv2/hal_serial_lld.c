@@ -84,6 +84,24 @@
 #define UART8 USART8
 #endif
 
+#if STM32_SERIAL_USE_FIFO && !defined(USART_CR1_FIFOEN)
+#error "STM32_SERIAL_USE_FIFO requires USART FIFOs"
+#endif
+
+/**
+ * @brief   Depth of the USART FIFOs.
+ */
+#define USART_FIFO_SIZE                     8U
+
+/**
+ * @brief   Statistics update.
+ */
+#if (STM32_SERIAL_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#define _sd_stats_add(sdp, field, n)    ((sdp)->stats.field += (uint32_t)(n))
+#else
+#define _sd_stats_add(sdp, field, n)
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -263,10 +281,34 @@ static void usart_init(SerialDriver *sdp,
 
   /* Note that some bits are enforced.*/
   u->CR2 = config->cr2 | USART_CR2_LBDIE;
+#if STM32_SERIAL_USE_DMA == TRUE
+  /* Frames are moved by the DMA, the idle line interrupt marks the end of
+     each received burst.*/
+  u->CR3 = config->cr3 | USART_CR3_EIE | USART_CR3_DMAR | USART_CR3_DMAT;
+  u->CR1 = config->cr1 | USART_CR1_UE | USART_CR1_PEIE |
+                         USART_CR1_IDLEIE | USART_CR1_TE |
+                         USART_CR1_RE;
+#elif STM32_SERIAL_USE_FIFO == TRUE
+  /* FIFOEN can only be changed while the USART is disabled, on a
+     reconfiguration UE is cleared by a write of its own.*/
+  u->CR1 &= ~USART_CR1_UE;
+
+  /* Interrupts on the RX FIFO threshold, the idle line interrupt collects
+     the frames left below the threshold at the end of a burst.*/
+  u->CR3 = config->cr3 | USART_CR3_EIE | USART_CR3_RXFTIE |
+           (STM32_SERIAL_RX_FIFO_THRESHOLD << USART_CR3_RXFTCFG_Pos) |
+           (STM32_SERIAL_TX_FIFO_THRESHOLD << USART_CR3_TXFTCFG_Pos);
+  /* UE is set by a second write.*/
+  u->CR1 = (config->cr1 & ~USART_CR1_UE) | USART_CR1_PEIE |
+           USART_CR1_FIFOEN | USART_CR1_IDLEIE |
+           USART_CR1_TE | USART_CR1_RE;
+  u->CR1 |= USART_CR1_UE;
+#else
   u->CR3 = config->cr3 | USART_CR3_EIE;
   u->CR1 = config->cr1 | USART_CR1_UE | USART_CR1_PEIE |
                          USART_CR1_RXNEIE | USART_CR1_TE |
                          USART_CR1_RE;
+#endif
   u->ICR = 0xFFFFFFFFU;
 
   /* Deciding mask to be applied on the data register on receive, this is
@@ -323,6 +365,235 @@ static void set_error(SerialDriver *sdp, uint32_t isr) {
   osalSysUnlockFromISR();
 }
 
+#if (STM32_SERIAL_USE_DMA == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Publishes the bytes written by the receive DMA.
+ * @details The input queue write pointer is moved to the DMA position and
+ *          the counter is updated with a single lock for the whole burst.
+ * @note    If the DMA overtakes the readers then the unread data is lost
+ *          and @p SD_QUEUE_FULL_ERROR is reported.
+ * @note    A DMA wrap with the position not behind the previous one means
+ *          that a whole buffer has been received between two services.
+ *          If more than a buffer has been received only the last buffer
+ *          of data is kept and @p SD_OVERRUN_ERROR is reported too.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] flags     DMA events since the previous service
+ */
+static void sd_dma_serve_rx(SerialDriver *sdp, uint32_t flags) {
+  input_queue_t *iqp = &sdp->iqueue;
+  size_t size = (size_t)(iqp->q_top - iqp->q_buffer);
+  size_t last = (size_t)(iqp->q_wrptr - iqp->q_buffer);
+  size_t pos, n;
+  bool lap;
+
+  pos = size - (size_t)(sdp->dmarx->stream->CBR1 & DMA_CBR1_BNDT_Msk);
+  if (pos >= size) {
+    pos = 0U;
+  }
+  n   = (pos + size - last) % size;
+  lap = ((flags & DMA_CSR_TCF) != 0U) && (pos >= last);
+  if (lap) {
+    n += size;
+  }
+  else if (n == 0U) {
+    return;
+  }
+  _sd_stats_add(sdp, rxbytes, n);
+
+  /* The DMA stores the parity bit too, it is masked out here.*/
+  if (sdp->rxmask != 0xFFU) {
+    uint8_t *p = iqp->q_wrptr;
+    size_t i;
+
+    for (i = 0U; i < (n > size ? size : n); i++) {
+      *p++ &= sdp->rxmask;
+      if (p >= iqp->q_top) {
+        p = iqp->q_buffer;
+      }
+    }
+  }
+
+  osalSysLockFromISR();
+  if (n > size) {
+    chnAddFlagsI(sdp, SD_OVERRUN_ERROR);
+  }
+  if (iqIsEmptyI(iqp)) {
+    chnAddFlagsI(sdp, CHN_INPUT_AVAILABLE);
+  }
+  iqp->q_wrptr = iqp->q_buffer + pos;
+  if (iqp->q_counter + n > size) {
+    iqp->q_counter = size;
+    iqp->q_rdptr   = iqp->q_wrptr;
+    chnAddFlagsI(sdp, SD_QUEUE_FULL_ERROR);
+  }
+  else {
+    iqp->q_counter += n;
+  }
+  osalThreadDequeueAllI(&iqp->q_waiting, MSG_OK);
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Starts the transmission of the next contiguous output span.
+ * @note    This function must be invoked from a locked context.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void sd_dma_start_send(SerialDriver *sdp) {
+  output_queue_t *oqp = &sdp->oqueue;
+  size_t n;
+
+  /* A span is already in progress, the next one is started on its
+     completion.*/
+  if (sdp->txspan != 0U) {
+    return;
+  }
+
+  /* Pending bytes up to the end of the circular buffer.*/
+  n = (size_t)(oqp->q_top - oqp->q_buffer) - oqp->q_counter;
+  if (n > (size_t)(oqp->q_top - oqp->q_rdptr)) {
+    n = (size_t)(oqp->q_top - oqp->q_rdptr);
+  }
+  if (n > (size_t)STM32_DMA_MAX_TRANSFER) {
+    n = (size_t)STM32_DMA_MAX_TRANSFER;
+  }
+  if (n == 0U) {
+    return;
+  }
+
+  sdp->txspan = n;
+  sdp->dmatx->stream->CSAR = (uint32_t)oqp->q_rdptr;
+  sdp->dmatx->stream->CBR1 = (uint32_t)n;
+  sdp->dmatx->stream->CCR |= DMA_CCR_TCIE | DMA_CCR_DTEIE |
+                             DMA_CCR_ULEIE | DMA_CCR_USEIE;
+  dmaStreamEnable(sdp->dmatx);
+}
+
+/**
+ * @brief   Output queue notification in DMA mode.
+ *
+ * @param[in] qp        pointer to the output queue
+ */
+static void notify_dma(io_queue_t *qp) {
+  SerialDriver *sdp = (SerialDriver *)qp->q_link;
+
+  if (sdp->state == SD_READY) {
+    sd_dma_start_send(sdp);
+  }
+}
+
+/**
+ * @brief   Receive DMA interrupt, half and end of the input buffer.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] flags     pre-shifted content of the CSR register
+ */
+static void sd_dma_serve_rx_irq(SerialDriver *sdp, uint32_t flags) {
+
+  _sd_stats_add(sdp, irqs, 1);
+
+  if ((flags & (DMA_CSR_USEF | DMA_CSR_ULEF | DMA_CSR_DTEF)) != 0U) {
+    STM32_SERIAL_DMA_ERROR_HOOK(sdp);
+  }
+
+  sd_dma_serve_rx(sdp, flags);
+}
+
+/**
+ * @brief   Transmit DMA interrupt, end of an output span.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] flags     pre-shifted content of the CSR register
+ */
+static void sd_dma_serve_tx_irq(SerialDriver *sdp, uint32_t flags) {
+  output_queue_t *oqp = &sdp->oqueue;
+
+  _sd_stats_add(sdp, irqs, 1);
+  if ((flags & (DMA_CSR_USEF | DMA_CSR_ULEF | DMA_CSR_DTEF)) != 0U) {
+    STM32_SERIAL_DMA_ERROR_HOOK(sdp);
+  }
+
+  dmaStreamDisable(sdp->dmatx);
+  _sd_stats_add(sdp, txbytes, sdp->txspan);
+
+  /* The whole span is returned to the writers at once.*/
+  osalSysLockFromISR();
+  oqp->q_rdptr += sdp->txspan;
+  if (oqp->q_rdptr >= oqp->q_top) {
+    oqp->q_rdptr = oqp->q_buffer;
+  }
+  oqp->q_counter += sdp->txspan;
+  sdp->txspan = 0U;
+  osalThreadDequeueAllI(&oqp->q_waiting, MSG_OK);
+
+  if (oqIsEmptyI(oqp)) {
+    /* Waiting for the physical end of the transmission.*/
+    chnAddFlagsI(sdp, CHN_OUTPUT_EMPTY);
+    sdp->usart->CR1 |= USART_CR1_TCIE;
+  }
+  else {
+    sd_dma_start_send(sdp);
+  }
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Allocates and prepares the DMA streams.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] rxreq     receive DMA request line
+ * @param[in] txreq     transmit DMA request line
+ * @param[in] priority  DMA interrupts priority
+ */
+static void sd_dma_alloc(SerialDriver *sdp, uint32_t rxreq, uint32_t txreq,
+                         uint32_t priority) {
+
+  sdp->dmarx = dmaStreamAllocI(STM32_DMA_STREAM_ID_ANY, priority,
+                               (stm32_dmaisr_t)sd_dma_serve_rx_irq,
+                               (void *)sdp);
+  osalDbgAssert(sdp->dmarx != NULL, "unable to allocate stream");
+  sdp->dmatx = dmaStreamAllocI(STM32_DMA_STREAM_ID_ANY, priority,
+                               (stm32_dmaisr_t)sd_dma_serve_tx_irq,
+                               (void *)sdp);
+  osalDbgAssert(sdp->dmatx != NULL, "unable to allocate stream");
+
+  sdp->dmarx->stream->CTR2 = rxreq;
+  sdp->dmatx->stream->CTR1 = DMA_CTR1_SINC;
+  sdp->dmatx->stream->CTR2 = txreq | DMA_CTR2_DREQ;
+  sdp->dmatx->stream->CDAR = (uint32_t)&sdp->usart->TDR;
+  sdp->txspan = 0U;
+
+  /* The output queue is drained by the DMA from now on.*/
+  sdp->oqueue.q_notify = notify_dma;
+}
+
+/**
+ * @brief   Starts the circular receive DMA on the input queue buffer.
+ * @note    Unread input is discarded.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void sd_dma_start_receive(SerialDriver *sdp) {
+  input_queue_t *iqp = &sdp->iqueue;
+
+  dmaStreamDisable(sdp->dmarx);
+  iqResetI(iqp);
+
+  dmaLliObjectInit(&sdp->rxlli,
+                   DMA_CTR1_DINC,
+                   (dmaStreamGetRequestSource(sdp->dmarx) &
+                    ~(DMA_CTR2_SWREQ | DMA_CTR2_DREQ)) |
+                   STM32_DMA_CTR2_TCEM_LLI,
+                   &sdp->usart->RDR, iqp->q_buffer,
+                   (size_t)(iqp->q_top - iqp->q_buffer));
+  dmaLliLink(&sdp->rxlli, &sdp->rxlli);
+  dmaStreamStartLinkedListI(sdp->dmarx, &sdp->rxlli,
+                            DMA_CCR_TCIE  | DMA_CCR_HTIE  | DMA_CCR_DTEIE |
+                            DMA_CCR_ULEIE | DMA_CCR_USEIE);
+}
+#endif /* STM32_SERIAL_USE_DMA == TRUE */
+
 #if STM32_SERIAL_USE_USART1 || defined(__DOXYGEN__)
 static void notify1(io_queue_t *qp) {
 
@@ -718,11 +989,19 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 #if STM32_SERIAL_USE_USART1
     if (&SD1 == sdp) {
       rccEnableUSART1(true);
+#if STM32_SERIAL_USE_DMA == TRUE
+      sd_dma_alloc(sdp, STM32_DMAMUX1_USART1_RX, STM32_DMAMUX1_USART1_TX,
+                   STM32_SERIAL_USART1_PRIORITY);
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_USART2
     if (&SD2 == sdp) {
       rccEnableUSART2(true);
+#if STM32_SERIAL_USE_DMA == TRUE
+      sd_dma_alloc(sdp, STM32_DMAMUX1_USART2_RX, STM32_DMAMUX1_USART2_TX,
+                   STM32_SERIAL_USART2_PRIORITY);
+#endif
 #if /*defined(STM32_USART2_SUPPRESS_ISR) &&*/ defined(STM32_USART2_HANDLER)
       nvicEnableVector(STM32_USART2_NUMBER, STM32_SERIAL_USART2_PRIORITY);
 #endif
@@ -731,11 +1010,19 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 #if STM32_SERIAL_USE_USART3
     if (&SD3 == sdp) {
       rccEnableUSART3(true);
+#if STM32_SERIAL_USE_DMA == TRUE
+      sd_dma_alloc(sdp, STM32_DMAMUX1_USART3_RX, STM32_DMAMUX1_USART3_TX,
+                   STM32_SERIAL_USART3_PRIORITY);
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_UART4
     if (&SD4 == sdp) {
       rccEnableUART4(true);
+#if STM32_SERIAL_USE_DMA == TRUE
+      sd_dma_alloc(sdp, STM32_DMAMUX1_USART4_RX, STM32_DMAMUX1_USART4_TX,
+                   STM32_SERIAL_UART4_PRIORITY);
+#endif
 #if /*defined(STM32_UART4_SUPPRESS_ISR) &&*/ defined(STM32_UART4_HANDLER)
       nvicEnableVector(STM32_UART4_NUMBER, STM32_SERIAL_UART4_PRIORITY);
 #endif
@@ -744,29 +1031,52 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 #if STM32_SERIAL_USE_UART5
     if (&SD5 == sdp) {
       rccEnableUART5(true);
+#if STM32_SERIAL_USE_DMA == TRUE
+      sd_dma_alloc(sdp, STM32_DMAMUX1_UART5_RX, STM32_DMAMUX1_UART5_TX,
+                   STM32_SERIAL_UART5_PRIORITY);
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_USART6
     if (&SD6 == sdp) {
       rccEnableUSART6(true);
+#if STM32_SERIAL_USE_DMA == TRUE
+      sd_dma_alloc(sdp, STM32_DMAMUX1_USART6_RX, STM32_DMAMUX1_USART6_TX,
+                   STM32_SERIAL_USART6_PRIORITY);
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_UART7
     if (&SD7 == sdp) {
       rccEnableUART7(true);
+#if STM32_SERIAL_USE_DMA == TRUE
+      sd_dma_alloc(sdp, STM32_DMAMUX1_UART7_RX, STM32_DMAMUX1_UART7_TX,
+                   STM32_SERIAL_UART7_PRIORITY);
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_UART8
     if (&SD8 == sdp) {
       rccEnableUART8(true);
+#if STM32_SERIAL_USE_DMA == TRUE
+      sd_dma_alloc(sdp, STM32_DMAMUX1_UART8_RX, STM32_DMAMUX1_UART8_TX,
+                   STM32_SERIAL_UART8_PRIORITY);
+#endif
     }
 #endif
 #if STM32_SERIAL_USE_LPUART1
     if (&LPSD1 == sdp) {
       rccEnableLPUART1(true);
+#if STM32_SERIAL_USE_DMA == TRUE
+      sd_dma_alloc(sdp, STM32_DMAMUX1_LPUART1_RX, STM32_DMAMUX1_LPUART1_TX,
+                   STM32_SERIAL_LPUART1_PRIORITY);
+#endif
     }
 #endif
   }
+#if STM32_SERIAL_USE_DMA == TRUE
+  sd_dma_start_receive(sdp);
+#endif
   usart_init(sdp, config);
 }
 
@@ -785,6 +1095,16 @@ void sd_lld_stop(SerialDriver *sdp) {
     /* UART is de-initialized then clocks are disabled.*/
     usart_deinit(sdp->usart);
 
+#if STM32_SERIAL_USE_DMA == TRUE
+    dmaStreamDisable(sdp->dmarx);
+    dmaStreamDisable(sdp->dmatx);
+    dmaStreamFreeI(sdp->dmarx);
+    dmaStreamFreeI(sdp->dmatx);
+    sdp->dmarx  = NULL;
+    sdp->dmatx  = NULL;
+    sdp->txspan = 0U;
+#endif
+
 #if STM32_SERIAL_USE_USART1
     if (&SD1 == sdp) {
       rccDisableUSART1();
@@ -852,6 +1172,8 @@ void sd_lld_serve_interrupt(SerialDriver *sdp) {
   uint32_t cr1 = u->CR1;
   uint32_t isr;
 
+  _sd_stats_add(sdp, irqs, 1);
+
   /* Reading and clearing status.*/
   isr = u->ISR;
   u->ICR = isr;
@@ -867,6 +1189,64 @@ void sd_lld_serve_interrupt(SerialDriver *sdp) {
     osalSysUnlockFromISR();
   }
 
+#if STM32_SERIAL_USE_DMA == TRUE
+  /* Idle line, the burst received so far is published.*/
+  if (isr & USART_ISR_IDLE) {
+    uint32_t flags;
+
+    /* DMA events not served yet are consumed here.*/
+    flags = sdp->dmarx->stream->CSR & (DMA_CSR_HTF | DMA_CSR_TCF);
+    sdp->dmarx->stream->CFCR = flags;
+    sd_dma_serve_rx(sdp, flags);
+  }
+#elif STM32_SERIAL_USE_FIFO == TRUE
+  /* RX FIFO threshold or idle line, the FIFO is drained up to its depth
+     inside a single critical section.*/
+  if (isr & USART_ISR_RXNE_RXFNE) {
+    uint32_t n = 0U;
+
+    osalSysLockFromISR();
+    do {
+      sdIncomingDataI(sdp, (uint8_t)u->RDR & sdp->rxmask);
+      n++;
+      isr = u->ISR;
+    } while ((isr & USART_ISR_RXNE_RXFNE) && (n < USART_FIFO_SIZE));
+    osalSysUnlockFromISR();
+    _sd_stats_add(sdp, rxbytes, n);
+  }
+
+  /* TX FIFO not full after a notification or TX FIFO threshold, the FIFO
+     is filled up to its depth inside a single critical section. After the
+     first fill the FIFO threshold interrupt takes over.*/
+  if ((cr1 & USART_CR1_TXEIE) || (u->CR3 & USART_CR3_TXFTIE)) {
+    if (isr & USART_ISR_TXE_TXFNF) {
+      uint32_t n = 0U;
+      msg_t b;
+
+      osalSysLockFromISR();
+      do {
+        b = oqGetI(&sdp->oqueue);
+        if (b < MSG_OK) {
+          break;
+        }
+        u->TDR = b;
+        n++;
+        isr = u->ISR;
+      } while ((isr & USART_ISR_TXE_TXFNF) && (n < USART_FIFO_SIZE));
+      u->CR1 &= ~USART_CR1_TXEIE;
+      if (b < MSG_OK) {
+        chnAddFlagsI(sdp, CHN_OUTPUT_EMPTY);
+        u->CR3 &= ~USART_CR3_TXFTIE;
+      }
+      else {
+        u->CR3 |= USART_CR3_TXFTIE;
+      }
+      cr1 = u->CR1;
+      osalSysUnlockFromISR();
+      _sd_stats_add(sdp, txbytes, n);
+    }
+  }
+#else
   /* Data available, note it is a while in order to handle two situations:
      1) Another byte arrived after removing the previous one, this would cause
         an extra interrupt to serve.
@@ -878,8 +1258,11 @@ void sd_lld_serve_interrupt(SerialDriver *sdp) {
     osalSysUnlockFromISR();
 
     isr = u->ISR;
+    _sd_stats_add(sdp, rxbytes, 1);
   }
+#endif
 
+#if STM32_SERIAL_USE_FIFO == FALSE
   /* Transmission buffer empty, note it is a while in order to handle two
      situations:
      1) The data registers has been emptied immediately after writing it, this
@@ -902,8 +1285,10 @@ void sd_lld_serve_interrupt(SerialDriver *sdp) {
       osalSysUnlockFromISR();
 
       isr = u->ISR;
+      _sd_stats_add(sdp, txbytes, 1);
     }
   }
+#endif
 
   /* Physical transmission end.*/
   if ((cr1 & USART_CR1_TCIE) && (isr & USART_ISR_TC)) {
@@ -319,6 +319,65 @@
 #if !defined(STM32_SERIAL_LPUART1_OUT_BUF_SIZE) || defined(__DOXYGEN__)
 #define STM32_SERIAL_LPUART1_OUT_BUF_SIZE   SERIAL_BUFFERS_SIZE
 #endif
+
+/**
+ * @brief   DMA-backed queues switch.
+ * @details If set to @p TRUE the receiver writes directly into the input
+ *          queue buffer through a circular GPDMA linked list and the output
+ *          queue is drained by DMA in contiguous spans. Queue states are
+ *          updated once per burst instead of once per byte.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_SERIAL_USE_DMA) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USE_DMA                FALSE
+#endif
+
+/**
+ * @brief   FIFO threshold mode switch.
+ * @details If set to @p TRUE the USART FIFOs are enabled and the driver is
+ *          interrupted on the FIFO thresholds and on idle line instead of
+ *          on each frame. Each interrupt drains or fills up to the FIFO
+ *          depth inside a single critical section.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_SERIAL_USE_FIFO) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USE_FIFO               FALSE
+#endif
+
+/**
+ * @brief   RX FIFO threshold.
+ * @details Value of the RXFTCFG field, from 0 (1/8) to 5 (full).
+ */
+#if !defined(STM32_SERIAL_RX_FIFO_THRESHOLD) || defined(__DOXYGEN__)
+#define STM32_SERIAL_RX_FIFO_THRESHOLD      3
+#endif
+
+/**
+ * @brief   TX FIFO threshold.
+ * @details Value of the TXFTCFG field, from 0 (1/8) to 5 (empty).
+ */
+#if !defined(STM32_SERIAL_TX_FIFO_THRESHOLD) || defined(__DOXYGEN__)
+#define STM32_SERIAL_TX_FIFO_THRESHOLD      2
+#endif
+
+/**
+ * @brief   Interrupt statistics switch.
+ * @details If set to @p TRUE each driver counts its interrupts and the
+ *          bytes moved by them, see @p sdstats_t.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_SERIAL_USE_STATISTICS) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USE_STATISTICS         FALSE
+#endif
+
+/**
+ * @brief   DMA error hook.
+ * @note    The default action for DMA errors is a system halt because DMA
+ *          error can only happen because programming errors.
+ */
+#if !defined(STM32_SERIAL_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_SERIAL_DMA_ERROR_HOOK(sdp)    osalSysHalt("DMA failure")
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -423,6 +482,28 @@
 #error "Invalid IRQ priority assigned to LPUART1"
 #endif
 
+#if STM32_SERIAL_USE_DMA && !defined(STM32U5)
+#error "STM32_SERIAL_USE_DMA requires the GPDMA linked-list support"
+#endif
+
+#if STM32_SERIAL_USE_DMA && STM32_SERIAL_USE_FIFO
+#error "STM32_SERIAL_USE_DMA and STM32_SERIAL_USE_FIFO are mutually exclusive"
+#endif
+
+#if (STM32_SERIAL_RX_FIFO_THRESHOLD < 0) || (STM32_SERIAL_RX_FIFO_THRESHOLD > 5)
+#error "invalid STM32_SERIAL_RX_FIFO_THRESHOLD value"
+#endif
+
+#if (STM32_SERIAL_TX_FIFO_THRESHOLD < 0) || (STM32_SERIAL_TX_FIFO_THRESHOLD > 5)
+#error "invalid STM32_SERIAL_TX_FIFO_THRESHOLD value"
+#endif
+
+#if STM32_SERIAL_USE_DMA
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+#endif
+
 /* Checks on allocation of USARTx units.*/
 #if STM32_SERIAL_USE_USART1
 #if defined(STM32_USART1_IS_USED)
@@ -528,6 +609,54 @@ typedef struct hal_serial_config {
   uint32_t                  cr3;
 } SerialConfig;
 
+#if (STM32_SERIAL_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Serial driver interrupt statistics.
+ * @note    The average number of bytes moved per interrupt is
+ *          <tt>(rxbytes + txbytes) / irqs</tt>.
+ */
+typedef struct {
+  /**
+   * @brief   Number of served USART and DMA interrupts.
+   */
+  uint32_t                  irqs;
+  /**
+   * @brief   Number of received bytes.
+   */
+  uint32_t                  rxbytes;
+  /**
+   * @brief   Number of transmitted bytes.
+   */
+  uint32_t                  txbytes;
+} sdstats_t;
+
+/**
+ * @brief   @p SerialDriver statistics data.
+ */
+#define _serial_driver_stats_data                                           \
+  /* Interrupt statistics.*/                                                \
+  sdstats_t                 stats;
+#else
+#define _serial_driver_stats_data
+#endif
+
+#if (STM32_SERIAL_USE_DMA == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   @p SerialDriver DMA specific data.
+ */
+#define _serial_driver_dma_data                                             \
+  /* Receive DMA stream.*/                                                  \
+  const stm32_dma_stream_t  *dmarx;                                         \
+  /* Transmit DMA stream.*/                                                 \
+  const stm32_dma_stream_t  *dmatx;                                         \
+  /* Size of the transmit span in progress, zero if idle.*/                 \
+  size_t                    txspan;                                         \
+  /* Self-linked node feeding the input queue buffer.*/                     \
+  stm32_dma_lli_t           rxlli;
+#else
+#define _serial_driver_dma_data
+#endif
+
 /**
  * @brief   @p SerialDriver specific data.
  */
@@ -545,7 +674,9 @@ typedef struct hal_serial_config {
   /* Clock frequency for the associated USART/UART.*/                       \
   uint32_t                  clock;                                          \
   /* Mask to be applied on received frames.*/                               \
-  uint8_t                   rxmask;
+  uint8_t                   rxmask;                                         \
+  _serial_driver_dma_data                                                   \
+  _serial_driver_stats_data
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
@@ -235,6 +235,37 @@ static void uart_enter_rx_idle_loop(UARTDriver *uartp) {
   dmaStreamEnable(uartp->dmarx);
 }
 
+#if (STM32_UART_USE_RX_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the receive stream producer index.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @return              The ring position of the next frame to be written.
+ */
+static size_t uart_rx_stream_index(UARTDriver *uartp) {
+  size_t pos;
+
+  pos = uartp->rxstream_size -
+        (size_t)(uartp->dmarx->stream->CBR1 & DMA_CBR1_BNDT_Msk);
+
+  /* The counter reads zero for a moment while the node is reloaded.*/
+  return pos >= uartp->rxstream_size ? 0U : pos;
+}
+
+/**
+ * @brief   Returns the stopped RX DMA channel to plain block transfers.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+static void uart_rx_stream_reset(UARTDriver *uartp) {
+
+  uartp->rxstream_cb = NULL;
+  uartp->dmarx->stream->CLLR  = 0U;
+  uartp->dmarx->stream->CBR1  = 0U;
+  uartp->dmarx->stream->CTR2 &= ~DMA_CTR2_TCEM_Msk;
+}
+#endif
+
 /**
  * @brief   USART de-initialization.
  * @details This function must be invoked with interrupts disabled.
@@ -246,6 +277,12 @@ static void usart_stop(UARTDriver *uartp) {
   /* Stops RX and TX DMA channels.*/
   dmaStreamDisable(uartp->dmarx);
   dmaStreamDisable(uartp->dmatx);
+#if STM32_UART_USE_RX_STREAM == TRUE
+  /* The linked list must not be followed by a later receive.*/
+  if (uartp->rxstream_cb != NULL) {
+    uart_rx_stream_reset(uartp);
+  }
+#endif
 
   /* Stops USART operations.*/
 #if !defined(STM32U5) // STM32U5 PORT
@@ -365,6 +402,25 @@ static void uart_lld_serve_rx_end_irq(UARTDriver *uartp, uint32_t flags) {
   (void)flags;
 #endif
 
+#if STM32_UART_USE_RX_STREAM == TRUE
+  if (uartp->rxstream_cb != NULL) {
+    uartflags_t events = 0U;
+
+    /* Streaming, the DMA keeps running on the ring, only the position is
+       reported.*/
+    if ((flags & DMA_CSR_HTF) != 0U) {
+      events |= UART_STREAM_HALF;
+    }
+    if ((flags & DMA_CSR_TCF) != 0U) {
+      events |= UART_STREAM_FULL;
+    }
+    if (events != 0U) {
+      uartp->rxstream_cb(uartp, events, uart_rx_stream_index(uartp));
+    }
+    return;
+  }
+#endif
+
   if (uartp->rxstate == UART_RX_IDLE) {
     /* Receiver in idle state, a callback is generated, if enabled, for each
        received character and then the driver stays in the same state.*/
@@ -988,6 +1044,9 @@ void uart_lld_start(UARTDriver *uartp) {
     uartp->dmatx->stream->CDAR = (uint32_t)&uartp->usart->TDR ;
 #endif
     uartp->rxbuf = 0;
+#if STM32_UART_USE_RX_STREAM == TRUE
+    uartp->rxstream_cb = NULL;
+#endif
   }
 
   uartp->rxstate = UART_RX_IDLE;
@@ -1149,6 +1208,11 @@ size_t uart_lld_stop_send(UARTDriver *uartp) {
  * @notapi
  */
 void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf) {
+
+#if STM32_UART_USE_RX_STREAM == TRUE
+  osalDbgAssert(uartp->rxstream_cb == NULL, "receive stream active");
+#endif
+
   /* Stopping previous activity (idle state).*/
   dmaStreamDisable(uartp->dmarx);
 #if !defined(STM32U5) // STM32U5 PORT
@@ -1184,6 +1248,10 @@ void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf) {
 size_t uart_lld_stop_receive(UARTDriver *uartp) {
   size_t n;
 
+#if STM32_UART_USE_RX_STREAM == TRUE
+  osalDbgAssert(uartp->rxstream_cb == NULL, "receive stream active");
+#endif
+
   dmaStreamDisable(uartp->dmarx);
   n = dmaStreamGetTransactionSize(uartp->dmarx);
 #if 0 
@@ -1229,6 +1297,17 @@ void uart_lld_serve_interrupt(UARTDriver *uartp) {
 
   }
 
+#if STM32_UART_USE_RX_STREAM == TRUE
+  /* Idle line while streaming, the burst is over.*/
+  if ((uartp->rxstream_cb != NULL) && (isr & USART_ISR_IDLE)) {
+    uartp->rxstream_cb(uartp, UART_STREAM_IDLE, uart_rx_stream_index(uartp));
+
+    /* The idle event belongs to the stream, a receiver timeout is still
+       served below.*/
+    isr &= ~USART_ISR_IDLE;
+  }
+#endif
+
   /* Timeout interrupt sources are only checked if enabled in CR1.*/
   if (((cr1 & USART_CR1_IDLEIE) && (isr & USART_ISR_IDLE)) ||
       ((cr1 & USART_CR1_RTOIE) && (isr & USART_ISR_RTOF))) {
@@ -1236,6 +1315,102 @@ void uart_lld_serve_interrupt(UARTDriver *uartp) {
   }
 }
 
+#if (STM32_UART_USE_RX_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a continuous receive stream.
+ * @details The receiver idle loop is replaced by a self-linked GPDMA node
+ *          writing into @p rxbuf as a ring. The callback is invoked when
+ *          the first half of the ring is filled, when the ring wraps around
+ *          and when the line goes idle after a burst, each time with the
+ *          current producer index. No per-frame interrupt is generated.
+ * @note    The USART idle interrupt is used by the stream, the
+ *          @p timeout_cb callback is not invoked on idle while streaming.
+ * @note    Frames of 9 bits are not supported.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[out] rxbuf    the pointer to the ring buffer
+ * @param[in] n         ring size in frames
+ * @param[in] cb        stream events callback
+ *
+ * @api
+ */
+void uartSTM32StartReceiveStream(UARTDriver *uartp, void *rxbuf, size_t n,
+                                 uartstreamcb_t cb) {
+
+  osalDbgCheck((uartp != NULL) && (rxbuf != NULL) && (cb != NULL) &&
+               (n >= 2U) && (n <= STM32_DMA_MAX_TRANSFER));
+
+  osalSysLock();
+  osalDbgAssert(uartp->state == UART_READY, "not active");
+  osalDbgAssert(uartp->rxstate == UART_RX_IDLE, "receive in progress");
+  osalDbgAssert((uartp->config->cr1 & (USART_CR1_M | USART_CR1_PCE)) !=
+                USART_CR1_M0, "unsupported frame size");
+
+  /* Stopping the idle loop, the stream takes its place.*/
+  dmaStreamDisable(uartp->dmarx);
+
+  uartp->rxstream_cb   = cb;
+  uartp->rxstream_size = n;
+  dmaLliObjectInit(&uartp->rxstream_lli,
+                   DMA_CTR1_DINC,
+                   (dmaStreamGetRequestSource(uartp->dmarx) &
+                    ~(DMA_CTR2_SWREQ | DMA_CTR2_DREQ)) |
+                   STM32_DMA_CTR2_TCEM_LLI,
+                   &uartp->usart->RDR, rxbuf, n);
+  dmaLliLink(&uartp->rxstream_lli, &uartp->rxstream_lli);
+
+  /* Idle line detection marks the end of each burst.*/
+  uartp->usart->ICR  = USART_ICR_IDLECF;
+  uartp->usart->CR1 |= USART_CR1_IDLEIE;
+
+  dmaStreamStartLinkedListI(uartp->dmarx, &uartp->rxstream_lli,
+                            DMA_CCR_TCIE  | DMA_CCR_HTIE  | DMA_CCR_DTEIE |
+                            DMA_CCR_ULEIE | DMA_CCR_USEIE);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops the receive stream.
+ * @details The receiver goes back to the idle loop.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @api
+ */
+void uartSTM32StopReceiveStream(UARTDriver *uartp) {
+
+  osalDbgCheck(uartp != NULL);
+
+  osalSysLock();
+  if (uartp->rxstream_cb != NULL) {
+    dmaStreamDisable(uartp->dmarx);
+
+    /* Restoring the idle interrupt setting and a plain block transfer.*/
+    uartp->usart->CR1 = (uartp->usart->CR1 & ~USART_CR1_IDLEIE) |
+                        (uartp->config->cr1 & USART_CR1_IDLEIE);
+    uart_rx_stream_reset(uartp);
+    uart_enter_rx_idle_loop(uartp);
+  }
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns the receive stream producer index.
+ * @note    This function can be called from any context.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @return              The ring position of the next frame to be written.
+ *
+ * @xclass
+ */
+size_t uartSTM32GetReceiveStreamIndexX(UARTDriver *uartp) {
+
+  osalDbgCheck(uartp->rxstream_cb != NULL);
+
+  return uart_rx_stream_index(uartp);
+}
+#endif /* STM32_UART_USE_RX_STREAM == TRUE */
+
 #endif /* HAL_USE_UART */
 
 /** @} */
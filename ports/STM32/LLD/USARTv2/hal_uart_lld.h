@@ -255,6 +255,17 @@
 #if !defined(STM32_UART_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
 #define STM32_UART_DMA_ERROR_HOOK(uartp)    osalSysHalt("DMA failure")
 #endif
+
+/**
+ * @brief   Continuous receive stream support.
+ * @details If set to @p TRUE the @p uartSTM32StartReceiveStream() API is
+ *          included, the receiver writes into a user ring through a
+ *          circular GPDMA linked list.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_UART_USE_RX_STREAM) || defined(__DOXYGEN__)
+#define STM32_UART_USE_RX_STREAM            FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -289,6 +300,10 @@
 #error "UART8 not present in the selected device"
 #endif
 
+#if STM32_UART_USE_RX_STREAM && !defined(STM32U5)
+#error "STM32_UART_USE_RX_STREAM requires the GPDMA linked-list support"
+#endif
+
 #if !STM32_UART_USE_USART1 && !STM32_UART_USE_USART2 &&                     \
     !STM32_UART_USE_USART3 && !STM32_UART_USE_UART4  &&                     \
     !STM32_UART_USE_UART5  && !STM32_UART_USE_USART6 &&                     \
@@ -687,6 +702,15 @@
  */
 typedef uint32_t uartflags_t;
 
+/**
+ * @name    Receive stream events
+ * @{
+ */
+#define UART_STREAM_HALF            1U  /**< @brief First ring half full.   */
+#define UART_STREAM_FULL            2U  /**< @brief Ring wrapped around.    */
+#define UART_STREAM_IDLE            4U  /**< @brief Line idle after data.   */
+/** @} */
+
 /**
  * @brief   Type of an UART driver.
  */
@@ -715,6 +739,20 @@ typedef void (*uartccb_t)(UARTDriver *uartp, uint16_t c);
  */
 typedef void (*uartecb_t)(UARTDriver *uartp, uartflags_t e);
 
+#if (STM32_UART_USE_RX_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Receive stream UART notification callback type.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] events    mask of @p UART_STREAM_HALF, @p UART_STREAM_FULL and
+ *                      @p UART_STREAM_IDLE
+ * @param[in] index     producer index into the ring, the position of the
+ *                      next frame to be written by the DMA
+ */
+typedef void (*uartstreamcb_t)(UARTDriver *uartp, uartflags_t events,
+                               size_t index);
+#endif
+
 /**
  * @brief   Type of an UART configuration structure.
  * @note    It could be empty on some architectures.
@@ -843,6 +881,20 @@ struct hal_uart_driver {
    * @brief   Default receive buffer while into @p UART_RX_IDLE state.
    */
   volatile uint16_t         rxbuf;
+#if (STM32_UART_USE_RX_STREAM == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Receive stream callback, @p NULL if not streaming.
+   */
+  uartstreamcb_t            rxstream_cb;
+  /**
+   * @brief   Receive stream ring size in frames.
+   */
+  size_t                    rxstream_size;
+  /**
+   * @brief   Self-linked node feeding the receive stream ring.
+   */
+  stm32_dma_lli_t           rxstream_lli;
+#endif
 };
 
 /*===========================================================================*/
@@ -896,6 +948,12 @@ extern "C" {
   void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf);
   size_t uart_lld_stop_receive(UARTDriver *uartp);
   void uart_lld_serve_interrupt(UARTDriver *uartp);
+#if STM32_UART_USE_RX_STREAM == TRUE
+  void uartSTM32StartReceiveStream(UARTDriver *uartp, void *rxbuf, size_t n,
+                                   uartstreamcb_t cb);
+  void uartSTM32StopReceiveStream(UARTDriver *uartp);
+  size_t uartSTM32GetReceiveStreamIndexX(UARTDriver *uartp);
+#endif
 #ifdef __cplusplus
 }
 #endif
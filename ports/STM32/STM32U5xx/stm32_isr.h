@@ -225,6 +225,15 @@
 
 #define STM32_QUADSPI1_NUMBER               92
 
+/*
+ * OCTOSPI units.
+ */
+#define STM32_OCTOSPI1_HANDLER              OCTOSPI1_IRQHandler
+#define STM32_OCTOSPI2_HANDLER              OCTOSPI2_IRQHandler
+
+#define STM32_OCTOSPI1_NUMBER               76
+#define STM32_OCTOSPI2_NUMBER               120
+
 /*
  * SDMMC units.
  */
@@ -362,6 +362,51 @@
   (void)RCC->AHB2RSTR;                                                      \
 }
 
+/**
+ * @brief   Enables the clock of one or more peripheral on the AHB2 bus,
+ *          second register.
+ *
+ * @param[in] mask      AHB2 peripherals mask
+ * @param[in] lp        low power enable flag
+ *
+ * @api
+ */
+#define rccEnableAHB2R2(mask, lp) {                                         \
+  RCC->AHB2ENR2 |= (mask);                                                  \
+  if (lp)                                                                   \
+    RCC->AHB2SMENR2 |= (mask);                                              \
+  else                                                                      \
+    RCC->AHB2SMENR2 &= ~(mask);                                             \
+  (void)RCC->AHB2SMENR2;                                                    \
+}
+
+/**
+ * @brief   Disables the clock of one or more peripheral on the AHB2 bus,
+ *          second register.
+ *
+ * @param[in] mask      AHB2 peripherals mask
+ *
+ * @api
+ */
+#define rccDisableAHB2R2(mask) {                                            \
+  RCC->AHB2ENR2 &= ~(mask);                                                 \
+  RCC->AHB2SMENR2 &= ~(mask);                                               \
+  (void)RCC->AHB2SMENR2;                                                    \
+}
+
+/**
+ * @brief   Resets one or more peripheral on the AHB2 bus, second register.
+ *
+ * @param[in] mask      AHB2 peripherals mask
+ *
+ * @api
+ */
+#define rccResetAHB2R2(mask) {                                              \
+  RCC->AHB2RSTR2 |= (mask);                                                 \
+  RCC->AHB2RSTR2 &= ~(mask);                                                \
+  (void)RCC->AHB2RSTR2;                                                     \
+}
+
 /**
  * @brief   Enables the clock of one or more peripheral on the AHB3 bus.
  *
@@ -1083,6 +1128,73 @@
 #define rccResetQUADSPI1() rccResetAHB3(RCC_AHB3RSTR_QSPIRST)
 /** @} */
 
+/**
+ * @name    OCTOSPI peripherals specific RCC operations
+ * @{
+ */
+/**
+ * @brief   Enables the OCTOSPI I/O manager clock.
+ *
+ * @param[in] lp        low power enable flag
+ *
+ * @api
+ */
+#define rccEnableOCTOSPIM(lp) rccEnableAHB2(RCC_AHB2ENR1_OCTOSPIMEN, lp)
+
+/**
+ * @brief   Disables the OCTOSPI I/O manager clock.
+ *
+ * @api
+ */
+#define rccDisableOCTOSPIM() rccDisableAHB2(RCC_AHB2ENR1_OCTOSPIMEN)
+
+/**
+ * @brief   Enables the OCTOSPI1 peripheral clock.
+ *
+ * @param[in] lp        low power enable flag
+ *
+ * @api
+ */
+#define rccEnableOCTOSPI1(lp) rccEnableAHB2R2(RCC_AHB2ENR2_OCTOSPI1EN, lp)
+
+/**
+ * @brief   Disables the OCTOSPI1 peripheral clock.
+ *
+ * @api
+ */
+#define rccDisableOCTOSPI1() rccDisableAHB2R2(RCC_AHB2ENR2_OCTOSPI1EN)
+
+/**
+ * @brief   Resets the OCTOSPI1 peripheral.
+ *
+ * @api
+ */
+#define rccResetOCTOSPI1() rccResetAHB2R2(RCC_AHB2RSTR2_OCTOSPI1RST)
+
+/**
+ * @brief   Enables the OCTOSPI2 peripheral clock.
+ *
+ * @param[in] lp        low power enable flag
+ *
+ * @api
+ */
+#define rccEnableOCTOSPI2(lp) rccEnableAHB2R2(RCC_AHB2ENR2_OCTOSPI2EN, lp)
+
+/**
+ * @brief   Disables the OCTOSPI2 peripheral clock.
+ *
+ * @api
+ */
+#define rccDisableOCTOSPI2() rccDisableAHB2R2(RCC_AHB2ENR2_OCTOSPI2EN)
+
+/**
+ * @brief   Resets the OCTOSPI2 peripheral.
+ *
+ * @api
+ */
+#define rccResetOCTOSPI2() rccResetAHB2R2(RCC_AHB2RSTR2_OCTOSPI2RST)
+/** @} */
+
 /**
  * @name    RNG peripherals specific RCC operations
  * @{
@@ -95,6 +95,8 @@
 #define STM32_DMAMUX1_SPI2_RX				8
 #define STM32_DMAMUX1_SPI2_TX				9
 
+#define STM32_DMAMUX1_USART1_RX             24
+#define STM32_DMAMUX1_USART1_TX             25
 #define STM32_DMAMUX1_USART2_RX				26
 #define STM32_DMAMUX1_USART2_TX				27
 #define STM32_DMAMUX1_USART3_RX             28
@@ -103,6 +105,8 @@
 #define STM32_DMAMUX1_USART4_TX             31
 #define STM32_DMAMUX1_UART5_RX				32
 #define STM32_DMAMUX1_UART5_TX				33
+#define STM32_DMAMUX1_LPUART1_RX            34
+#define STM32_DMAMUX1_LPUART1_TX            35
 
 /* SPI attributes.*/
 #define STM32_HAS_SPI1                      TRUE
@@ -115,6 +119,17 @@
 
 #define STM32_HAS_SPI5                      TRUE
 
+/* OCTOSPI attributes, OCTOSPI2 is not present on STM32U535/U545.*/
+#define STM32_HAS_OCTOSPI1                  TRUE
+#if defined(STM32U535xx) || defined(STM32U545xx)
+#define STM32_HAS_OCTOSPI2                  FALSE
+#else
+#define STM32_HAS_OCTOSPI2                  TRUE
+#endif
+
+#define STM32_DMAMUX1_OCTOSPI1              40
+#define STM32_DMAMUX1_OCTOSPI2              41
+
 /* DMA attributes.*/
 #define STM32_DMA1_NUM_CHANNELS             8
 #define STM32_DMA2_NUM_CHANNELS             0